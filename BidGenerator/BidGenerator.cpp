@@ -0,0 +1,338 @@
+//============================================================================
+// Name        : BidGenerator.cpp
+// Author      : Jacob Griggs
+// Version     : 1.0
+// Copyright   : Copyright � 2023 SNHU COCE
+// Description : Synthetic eBid dataset generator for scale testing
+//============================================================================
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+//============================================================================
+// Global definitions visible to all methods and classes
+//============================================================================
+
+// the exact 21-column header of the eBid monthly sales exports
+const string EBID_HEADER =
+        "Auction Title ,Auction ID,Department ,Close Date ,Winning Bid ,CC Fee,"
+        "Fee Percent,Auction Fee Subtotal,Fund,Auction Fee Total,Pay Status ,"
+        "Paid Date ,Asset #,Inventory ID,Decal /Vehicle ID,VTR Number,"
+        "Receipt Number ,Cap,Expenses,Net Sales,Business Unit";
+
+// first auction ID handed out, matching the range of the real exports
+const unsigned int FIRST_AUCTION_ID = 80000;
+
+// close dates are spread over this many days starting 1/1/2014
+const double CLOSE_DATE_SPAN_DAYS = 1095.0;
+
+// titles that dominate the real exports, used for duplicate rows
+const vector<string> COMMON_TITLES = {
+    "Dell Computer", "Dell Laptop", "Table", "File Cabinet", "Dell Laptop w/Bag",
+    "Chair", "Desk", "Bookcase", "Monitor", "Printer", "Couch", "Credenza",
+    "Office Chair", "Computer Desk", "Storage Cabinet", "Lateral File Cabinet",
+};
+
+// vocabulary for generated titles
+const vector<string> TITLE_WORDS = {
+    "Oak", "Metal", "Steel", "Wood", "Office", "Lot", "of", "Assorted", "Used",
+    "Vintage", "Large", "Small", "Dell", "HP", "Lenovo", "Laptop", "Computer",
+    "Printer", "Scanner", "Desk", "Chair", "Table", "Cabinet", "Shelf", "Bookcase",
+    "Truck", "Sedan", "Mower", "Trailer", "Projector", "Monitor", "Server", "Rack",
+    "Bleachers", "Lockers", "Tools", "Phones", "Copier", "Generator", "Pallet",
+};
+
+// departments and funds that appear in the real exports
+const vector<string> DEPARTMENTS = {
+    "ITS", "SCHOOL BOARD WAREHOUSE", "GENERAL SERVICES", "HEALTH",
+    "PUBLIC LIBRARY", "LP FIELD", "ASSESSOR OF PROPERTY", "PUBLIC PROPERTY",
+};
+const vector<string> KNOWN_FUNDS = { "General Fund", "Enterprise", "" };
+
+/**
+ * Tunable knobs for the generated dataset
+ */
+struct GeneratorConfig {
+    size_t rows = 100000;
+    unsigned int seed = 1;
+    double titleMean = 14.0;    // mean title length in characters
+    double titleStddev = 6.0;   // spread of title lengths
+    size_t titleMax = 72;       // longest title generated
+    double duplicateRate = 0.5; // chance a row reuses a common title
+    size_t fundCount = 3;       // distinct values in the Fund column
+    double quoteRate = 0.05;    // chance a title needs CSV quoting
+    double sortedness = 0.0;    // 0 = shuffled auction IDs, 1 = ascending
+};
+
+//============================================================================
+// Field formatting
+//============================================================================
+
+/**
+ * Quote a CSV field the way the eBid exports do, doubling inner quotes
+ */
+string csvField(const string& value) {
+    if (value.find_first_of(",\"") == string::npos) {
+        return value;
+    }
+    string quoted = "\"";
+    for (char ch : value) {
+        if (ch == '"') {
+            quoted += '"';
+        }
+        quoted += ch;
+    }
+    quoted += '"';
+    return quoted;
+}
+
+/**
+ * Format a dollar amount like the exports: "$1,234.50 "
+ */
+string money(double amount) {
+    char digits[32];
+    snprintf(digits, sizeof(digits), "%.2f", amount);
+    string whole = digits;
+    string cents = whole.substr(whole.size() - 3);
+    whole.erase(whole.size() - 3);
+
+    string grouped;
+    for (size_t i = 0; i < whole.size(); ++i) {
+        if (i > 0 && (whole.size() - i) % 3 == 0) {
+            grouped += ',';
+        }
+        grouped += whole[i];
+    }
+    return csvField("$" + grouped + cents + " ");
+}
+
+/**
+ * Format a day offset from 1/1/2014 as M/D/YYYY
+ *
+ * credit: Howard Hinnant's civil_from_days algorithm
+ */
+string dateFromDays(long days) {
+    long z = days + 735539; // days from 0000-03-01 to 2014-01-01
+    long era = z / 146097;
+    long doe = z - era * 146097;
+    long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    long doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    long mp = (5 * doy + 2) / 153;
+    long day = doy - (153 * mp + 2) / 5 + 1;
+    long month = mp < 10 ? mp + 3 : mp - 9;
+    long year = yoe + era * 400 + (month <= 2 ? 1 : 0);
+    return to_string(month) + "/" + to_string(day) + "/" + to_string(year);
+}
+
+//============================================================================
+// Row generation
+//============================================================================
+
+/**
+ * Build a title close to the requested length from the vocabulary
+ */
+string makeTitle(mt19937& rng, const GeneratorConfig& config, bool quoted) {
+    normal_distribution<double> lengthDist(config.titleMean, config.titleStddev);
+    size_t target = max(1.0, min<double>(config.titleMax, round(lengthDist(rng))));
+
+    string title;
+    while (title.size() < target) {
+        if (!title.empty()) {
+            title += ' ';
+        }
+        title += TITLE_WORDS[rng() % TITLE_WORDS.size()];
+    }
+    if (title.size() > config.titleMax) {
+        title.resize(config.titleMax);
+    }
+
+    if (quoted) {
+        // the exports quote titles with brand names in quotes or commas
+        if (rng() % 2 == 0) {
+            title = "\"" + TITLE_WORDS[rng() % TITLE_WORDS.size()] + "\" " + title;
+        } else {
+            title += ", " + TITLE_WORDS[rng() % TITLE_WORDS.size()];
+        }
+    }
+    return title;
+}
+
+/**
+ * Name of the n-th fund; the first few match the real exports
+ */
+string fundName(size_t index) {
+    if (index < KNOWN_FUNDS.size()) {
+        return KNOWN_FUNDS[index];
+    }
+    return "Fund " + to_string(index + 1);
+}
+
+/**
+ * Order the auction IDs: ascending when sortedness is 1, fully shuffled
+ * when it is 0, and a partial Fisher-Yates shuffle in between
+ */
+vector<unsigned int> makeAuctionOrder(mt19937& rng, const GeneratorConfig& config) {
+    vector<unsigned int> order(config.rows);
+    for (size_t i = 0; i < config.rows; ++i) {
+        order[i] = i;
+    }
+    uniform_real_distribution<double> chance(0.0, 1.0);
+    for (size_t i = 0; i + 1 < config.rows; ++i) {
+        if (chance(rng) >= config.sortedness) {
+            size_t j = i + rng() % (config.rows - i);
+            swap(order[i], order[j]);
+        }
+    }
+    return order;
+}
+
+/**
+ * Write the generated dataset as an eBid CSV
+ *
+ * @param path the CSV file to write
+ * @param config the dataset knobs
+ * @return false if the file could not be written
+ */
+bool generateBids(const string& path, const GeneratorConfig& config) {
+    ofstream out(path);
+    if (!out) {
+        return false;
+    }
+
+    mt19937 rng(config.seed);
+    uniform_real_distribution<double> chance(0.0, 1.0);
+    lognormal_distribution<double> amountDist(3.0, 1.5);
+    size_t fundCount = max<size_t>(1, config.fundCount);
+
+    vector<unsigned int> order = makeAuctionOrder(rng, config);
+
+    out << EBID_HEADER << "\n";
+    for (size_t row = 0; row < config.rows; ++row) {
+        unsigned int offset = order[row];
+
+        string title;
+        if (chance(rng) < config.duplicateRate) {
+            title = COMMON_TITLES[rng() % COMMON_TITLES.size()];
+        } else {
+            title = makeTitle(rng, config, chance(rng) < config.quoteRate);
+        }
+
+        double amount = round(amountDist(rng) * 100.0) / 100.0;
+        bool percentStyle = rng() % 3 == 0;
+        double feeRate = amount > 10000.0 ? 0.03 : 0.23;
+        double fee = round(amount * feeRate * 100.0) / 100.0;
+
+        // close dates advance with the auction ID so presorted IDs are
+        // also presorted by date, as in the real exports
+        long closeDay = offset * CLOSE_DATE_SPAN_DAYS / config.rows;
+        long paidDay = closeDay + 1 + rng() % 10;
+
+        out << csvField(title) << ","
+            << FIRST_AUCTION_ID + offset << ","
+            << DEPARTMENTS[rng() % DEPARTMENTS.size()] << ","
+            << dateFromDays(closeDay) << ","
+            << money(amount) << ","
+            << money(round(amount * 0.023 * 100.0) / 100.0) << ","
+            << (percentStyle ? to_string(int(feeRate * 100)) + "%" : (feeRate > 0.1 ? "0.23" : "0.03")) << ","
+            << money(fee) << ","
+            << fundName(rng() % fundCount) << ","
+            << money(fee) << ","
+            << "Successful,"
+            << dateFromDays(paidDay) << ","
+            << ","
+            << 80000 + rng() % 40000 << ","
+            << ",,"
+            << 3600000000u + rng() % 100000000u << ","
+            << "\"$3,000 \","
+            << (percentStyle ? "" : "$0.00 ") << ","
+            << money(amount - fee) << ","
+            << "0\n";
+    }
+    return static_cast<bool>(out);
+}
+
+/**
+ * Apply one --name=value option to the config
+ *
+ * @return false if the option is not recognized
+ */
+bool applyOption(GeneratorConfig& config, const string& arg) {
+    size_t equals = arg.find('=');
+    if (arg.compare(0, 2, "--") != 0 || equals == string::npos) {
+        return false;
+    }
+    string name = arg.substr(2, equals - 2);
+    const char* value = arg.c_str() + equals + 1;
+
+    if (name == "title-mean") {
+        config.titleMean = atof(value);
+    } else if (name == "title-stddev") {
+        config.titleStddev = atof(value);
+    } else if (name == "title-max") {
+        config.titleMax = strtoul(value, nullptr, 10);
+    } else if (name == "duplicate-rate") {
+        config.duplicateRate = atof(value);
+    } else if (name == "funds") {
+        config.fundCount = strtoul(value, nullptr, 10);
+    } else if (name == "quote-rate") {
+        config.quoteRate = atof(value);
+    } else if (name == "sortedness") {
+        config.sortedness = atof(value);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * The one and only main() method
+ *
+ * @param arg[1] path of the CSV file to write
+ * @param arg[2] number of bid rows to generate
+ * @param arg[3] random seed (optional)
+ * @param arg[4..] --title-mean, --title-stddev, --title-max,
+ *        --duplicate-rate, --funds, --quote-rate, --sortedness (optional)
+ */
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        cerr << "usage: " << argv[0] << " <output.csv> <rows> [seed] [--name=value ...]" << endl;
+        return 1;
+    }
+
+    GeneratorConfig config;
+    string path = argv[1];
+    config.rows = strtoull(argv[2], nullptr, 10);
+
+    int next = 3;
+    if (argc > 3 && argv[3][0] != '-') {
+        config.seed = strtoul(argv[3], nullptr, 10);
+        next = 4;
+    }
+    for (int i = next; i < argc; ++i) {
+        if (!applyOption(config, argv[i])) {
+            cerr << "Unknown option " << argv[i] << endl;
+            return 1;
+        }
+    }
+
+    clock_t ticks = clock();
+    if (!generateBids(path, config)) {
+        cerr << "Failed to write " << path << endl;
+        return 1;
+    }
+    ticks = clock() - ticks;
+
+    cout << config.rows << " bids written to " << path << endl;
+    cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+    return 0;
+}
@@ -6,9 +6,36 @@
 //============================================================================
 
 #include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
 #include <iostream>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <unordered_set>
 #include <time.h>
 
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// AVX2 sorting network for small key partitions (GCC and Clang on x86-64)
+#if defined(__GNUC__) && defined(__x86_64__)
+#define SORT_NETWORK_AVX2 1
+#include <immintrin.h>
+#endif
+
 #include "CSVparser.hpp"
 
 using namespace std;
@@ -17,8 +44,43 @@ using namespace std;
 // Global definitions visible to all methods and classes
 //============================================================================
 
+// smallest chunk worth handing to its own thread in the top-k query
+const size_t TOPK_CHUNK_MIN = 100000;
+
+// default settings for the external merge sort
+const size_t EXTERNAL_SORT_BUDGET_MB = 64;
+const string EXTERNAL_SORT_TEMP_DIR = ".";
+
+// natural merge sort tuning, as in TimSort
+const int MERGE_MIN_GALLOP = 7;
+const int MERGE_MIN_MERGE = 64;
+
+// block quick sort tuning
+const int PARTITION_BLOCK_SIZE = 128;
+const int BLOCK_SORT_LEAF_MAX = 16; // partitions this small go to the sorting network
+
+// LSD radix sort digit width; 6 passes cover a 64-bit key
+const int RADIX_BITS = 11;
+const int RADIX_BUCKETS = 1 << RADIX_BITS;
+const int RADIX_PASSES = (64 + RADIX_BITS - 1) / RADIX_BITS;
+
+// parallel sort never hands a thread fewer bids than this
+const size_t PARALLEL_SORT_MIN_CHUNK = 16384;
+
+// automatic sort selection: sample size and the calibration results file
+const size_t AUTO_SORT_SAMPLES = 1024;
+const string SORT_CALIBRATION_FILE = "sort_calibration.cfg";
+
+// default settings for the sorting benchmark
+const int BENCH_REPEATS = 5;
+const size_t BENCH_MIN_SIZE = 1000;
+const size_t BENCH_MAX_SIZE = 10000000;
+const size_t BENCH_QUADRATIC_MAX_SIZE = 10000; // cap for O(n^2) sorts
+
 // forward declarations
 double strToDouble(string str, char ch);
+struct Bid;
+vector<Bid> makeBenchmarkBids(size_t size, const string& order, unsigned int seed);
 
 // define a structure to hold bid information
 struct Bid {
@@ -31,6 +93,100 @@ struct Bid {
     }
 };
 
+//============================================================================
+// Operation counters for the sort algorithms
+//============================================================================
+
+/**
+ * Counter policy that records nothing. Every sort takes its counter
+ * policy as a template parameter, so with this policy the calls are
+ * empty inline functions and the sorts compile as if uncounted.
+ */
+struct NoSortStats {
+    void Compare(long long /*count*/ = 1) {}
+    void Swap(long long /*count*/ = 1) {}
+    void Move(long long /*count*/ = 1) {}
+    void Depth(int /*depth*/) {}
+    void Split(long long /*left*/, long long /*right*/) {}
+    void Merge(const NoSortStats& /*other*/) {}
+};
+
+/**
+ * Counter policy that records the work a sort performs
+ */
+struct SortStats {
+    long long comparisons = 0;
+    long long swaps = 0;
+    long long moves = 0;        // single-element moves and copies
+    int maxDepth = 0;           // deepest recursion level reached
+    long long partitions = 0;
+    double imbalanceSum = 0.0;  // |left - right| / (left + right) summed
+    double maxImbalance = 0.0;
+
+    void Compare(long long count = 1) {
+        comparisons += count;
+    }
+    void Swap(long long count = 1) {
+        swaps += count;
+    }
+    void Move(long long count = 1) {
+        moves += count;
+    }
+    void Depth(int depth) {
+        maxDepth = max(maxDepth, depth);
+    }
+    void Split(long long left, long long right) {
+        if (left + right == 0) {
+            return;
+        }
+        double imbalance = fabs(double(left - right)) / (left + right);
+        ++partitions;
+        imbalanceSum += imbalance;
+        maxImbalance = max(maxImbalance, imbalance);
+    }
+    // fold in the counts of a sort run on another thread
+    void Merge(const SortStats& other) {
+        comparisons += other.comparisons;
+        swaps += other.swaps;
+        moves += other.moves;
+        maxDepth = max(maxDepth, other.maxDepth);
+        partitions += other.partitions;
+        imbalanceSum += other.imbalanceSum;
+        maxImbalance = max(maxImbalance, other.maxImbalance);
+    }
+    double MeanImbalance() const {
+        return partitions == 0 ? 0.0 : imbalanceSum / partitions;
+    }
+};
+
+/**
+ * Display the operation counts of a sort
+ */
+void displaySortStats(const SortStats& stats) {
+    cout << "comparisons: " << stats.comparisons << " | swaps: " << stats.swaps
+            << " | moves: " << stats.moves << " | max depth: " << stats.maxDepth
+            << " | partition imbalance: mean " << stats.MeanImbalance()
+            << ", max " << stats.maxImbalance << endl;
+}
+
+/**
+ * Counted title comparison
+ */
+template <typename Stats>
+inline bool titleLess(const string& a, const string& b, Stats& stats) {
+    stats.Compare();
+    return a < b;
+}
+
+/**
+ * Counted swap of two bids
+ */
+template <typename Stats>
+inline void swapBids(Bid& a, Bid& b, Stats& stats) {
+    stats.Swap();
+    swap(a, b);
+}
+
 //============================================================================
 // Static methods used for testing
 //============================================================================
@@ -110,7 +266,8 @@ vector<Bid> loadBids(string csvPath) {
     return bids;
 }
 
-int partition(vector<Bid>& bids, int begin, int end) {
+template <typename Stats>
+int partition(vector<Bid>& bids, int begin, int end, Stats& stats) {
     int low = begin;
     int high = end;
     int middle = begin + (end - begin) / 2;
@@ -118,126 +275,2380 @@ int partition(vector<Bid>& bids, int begin, int end) {
 
     bool done = false;
     while (!done) {
-        while (bids[low].title < pivot) {
+        while (titleLess(bids[low].title, pivot, stats)) {
             ++low;
         }
-        while (pivot < bids[high].title) {
+        while (titleLess(pivot, bids[high].title, stats)) {
             --high;
         }
         if (low >= high) {
             done = true;
         } else {
-            swap(bids[low], bids[high]);
+            swapBids(bids[low], bids[high], stats);
             ++low;
             --high;
         }
     }
+    stats.Split(high - begin + 1, end - high);
     return high;
 }
 
-void quickSort(vector<Bid>& bids, int begin, int end) {
+template <typename Stats>
+void quickSort(vector<Bid>& bids, int begin, int end, Stats& stats, int depth = 1) {
     if (begin >= end) {
         return;
     }
-    int mid = partition(bids, begin, end);
-    quickSort(bids, begin, mid);
-    quickSort(bids, mid + 1, end);
+    stats.Depth(depth);
+    int mid = partition(bids, begin, end, stats);
+    quickSort(bids, begin, mid, stats, depth + 1);
+    quickSort(bids, mid + 1, end, stats, depth + 1);
 }
 
+void quickSort(vector<Bid>& bids, int begin, int end) {
+    NoSortStats stats;
+    quickSort(bids, begin, end, stats);
+}
 
-void selectionSort(vector<Bid>& bids) {
-    size_t size = bids.size();
-    for (size_t pos = 0; pos < size - 1; ++pos) {
-        size_t min = pos;
-        for (size_t j = pos + 1; j < size; ++j) {
-            if (bids[j].title < bids[min].title) {
-                min = j;
+/**
+ * Bentley-McIlroy three-way partition: a Hoare-style scan that parks
+ * titles equal to the pivot at both ends, then swaps them into the
+ * middle, so distinct keys cost no more swaps than the two-way partition
+ *
+ * @param lt receives the first index of the equal block
+ * @param gt receives the last index of the equal block
+ */
+template <typename Stats>
+void partition3Way(vector<Bid>& bids, int begin, int end, int& lt, int& gt, Stats& stats) {
+    swapBids(bids[begin], bids[begin + (end - begin) / 2], stats);
+    string pivot = bids[begin].title;
+
+    int i = begin;
+    int j = end + 1;
+    int p = begin;   // bids[begin..p] equal the pivot
+    int q = end + 1; // bids[q..end] equal the pivot
+    while (true) {
+        while (titleLess(bids[++i].title, pivot, stats)) {
+            if (i == end) {
+                break;
             }
         }
-        if (min != pos) {
-            swap(bids[pos], bids[min]);
+        while (titleLess(pivot, bids[--j].title, stats)) {
+            if (j == begin) {
+                break;
+            }
+        }
+        if (i == j && (stats.Compare(), bids[i].title == pivot)) {
+            swapBids(bids[++p], bids[i], stats);
+        }
+        if (i >= j) {
+            break;
         }
+        swapBids(bids[i], bids[j], stats);
+        stats.Compare(2);
+        if (bids[i].title == pivot) {
+            swapBids(bids[++p], bids[i], stats);
+        }
+        if (bids[j].title == pivot) {
+            swapBids(bids[--q], bids[j], stats);
+        }
+    }
+
+    // move the parked equal keys from both ends into the middle
+    i = j + 1;
+    for (int k = begin; k <= p; ++k) {
+        swapBids(bids[k], bids[j--], stats);
     }
+    for (int k = end; k >= q; --k) {
+        swapBids(bids[k], bids[i++], stats);
+    }
+    lt = j + 1;
+    gt = i - 1;
+    stats.Split(lt - begin, end - gt);
 }
 
+/**
+ * Quick sort with three-way partitioning; runs of equal titles are
+ * placed once and never recursed into again
+ */
+template <typename Stats>
+void quickSort3Way(vector<Bid>& bids, int begin, int end, Stats& stats, int depth = 1) {
+    if (begin >= end) {
+        return;
+    }
+    stats.Depth(depth);
+    int lt, gt;
+    partition3Way(bids, begin, end, lt, gt, stats);
+    quickSort3Way(bids, begin, lt - 1, stats, depth + 1);
+    quickSort3Way(bids, gt + 1, end, stats, depth + 1);
+}
 
- 
-double strToDouble(string str, char ch) {
-    str.erase(remove(str.begin(), str.end(), ch), str.end());
-    return atof(str.c_str());
+void quickSort3Way(vector<Bid>& bids, int begin, int end) {
+    NoSortStats stats;
+    quickSort3Way(bids, begin, end, stats);
 }
 
+
+//============================================================================
+// Adaptive natural merge sort (TimSort-style)
+//============================================================================
+
 /**
- * The one and only main() method
+ * Bookkeeping shared by the steps of one natural merge sort
  */
-int main(int argc, char* argv[]) {
+struct MergeState {
+    vector<Bid> tmp;             // holds the left run while merging
+    vector<pair<int, int>> runs; // pending runs as (base, length)
+    int minGallop = MERGE_MIN_GALLOP;
+};
 
-    // process command line arguments
-    string csvPath;
-    switch (argc) {
-    case 2:
-        csvPath = argv[1];
-        break;
-    default:
-        csvPath = "eBid_Monthly_Sales.csv";
+/**
+ * Exponential then binary search for the first of n bids for which
+ * goesBefore is false; goesBefore must be true for a prefix only
+ */
+template <typename Pred>
+int gallop(const Bid* first, int n, Pred goesBefore) {
+    int last = 0;
+    int ofs = 1;
+    while (ofs < n && goesBefore(first[ofs - 1])) {
+        last = ofs;
+        ofs = ofs * 2 + 1;
     }
+    const Bid* found = partition_point(first + last, first + min(ofs, n), goesBefore);
+    return found - first;
+}
 
-    // Define a vector to hold all the bids
-    vector<Bid> bids;
+/**
+ * Number of leading bids with a title strictly less than key
+ */
+template <typename Stats>
+int gallopLeft(const Bid* first, int n, const string& key, Stats& stats) {
+    return gallop(first, n, [&](const Bid& bid) { return titleLess(bid.title, key, stats); });
+}
 
-    // Define a timer variable
-    clock_t ticks;
+/**
+ * Number of leading bids with a title less than or equal to key
+ */
+template <typename Stats>
+int gallopRight(const Bid* first, int n, const string& key, Stats& stats) {
+    return gallop(first, n, [&](const Bid& bid) { return !titleLess(key, bid.title, stats); });
+}
 
-    int choice = 0;
-    while (choice != 9) {
-        cout << "Menu:" << endl;
-        cout << "  1. Load Bids" << endl;
-        cout << "  2. Display All Bids" << endl;
-        cout << "  3. Selection Sort All Bids" << endl;
-        cout << "  4. Quick Sort All Bids" << endl;
-        cout << "  9. Exit" << endl;
-        cout << "Enter choice: ";
-        cin >> choice;
+/**
+ * Smallest run length worth merging, between 32 and 64, chosen so the
+ * number of runs is close to a power of two
+ */
+int minRunLength(int n) {
+    int extra = 0;
+    while (n >= MERGE_MIN_MERGE) {
+        extra |= n & 1;
+        n >>= 1;
+    }
+    return n + extra;
+}
 
-        switch (choice) {
+/**
+ * Length of the run starting at lo; a descending run is reversed in
+ * place so every run ends up ascending. Descending runs may contain
+ * equal titles, whose original order is restored after the reversal.
+ */
+template <typename Stats>
+int countRun(vector<Bid>& bids, int lo, int hi, Stats& stats) {
+    int next = lo + 1;
+    if (next == hi) {
+        return 1;
+    }
+    if (titleLess(bids[next].title, bids[lo].title, stats)) {
+        while (next + 1 < hi && !titleLess(bids[next].title, bids[next + 1].title, stats)) {
+            ++next;
+        }
+        reverse(bids.begin() + lo, bids.begin() + next + 1);
+        stats.Swap((next + 1 - lo) / 2);
 
-        case 1:
-            // Initialize a timer variable before loading bids
-            ticks = clock();
+        // un-reverse each block of equal titles to keep the sort stable
+        for (int first = lo; first <= next; ) {
+            int last = first + 1;
+            while (last <= next && (stats.Compare(), bids[last].title == bids[first].title)) {
+                ++last;
+            }
+            reverse(bids.begin() + first, bids.begin() + last);
+            stats.Swap((last - first) / 2);
+            first = last;
+        }
+    } else {
+        while (next + 1 < hi && !titleLess(bids[next + 1].title, bids[next].title, stats)) {
+            ++next;
+        }
+    }
+    return next + 1 - lo;
+}
 
-            // Complete the method call to load the bids
-            bids = loadBids(csvPath);
+/**
+ * Extend the sorted prefix bids[lo..start) to cover bids[lo..hi)
+ */
+template <typename Stats>
+void binaryInsertionSort(vector<Bid>& bids, int lo, int hi, int start, Stats& stats) {
+    for (int i = start; i < hi; ++i) {
+        Bid pivot = move(bids[i]);
+        int pos = lo + gallopRight(&bids[lo], i - lo, pivot.title, stats);
+        move_backward(bids.begin() + pos, bids.begin() + i, bids.begin() + i + 1);
+        bids[pos] = move(pivot);
+        stats.Move(i - pos + 2);
+    }
+}
 
-            cout << bids.size() << " bids read" << endl;
+/**
+ * Stable merge of the adjacent runs at stack positions i and i + 1,
+ * switching to galloping when one run keeps winning
+ */
+template <typename Stats>
+void mergeAt(vector<Bid>& bids, MergeState& state, int i, Stats& stats) {
+    int base1 = state.runs[i].first;
+    int len1 = state.runs[i].second;
+    int base2 = state.runs[i + 1].first;
+    int len2 = state.runs[i + 1].second;
+    state.runs[i].second = len1 + len2;
+    state.runs.erase(state.runs.begin() + i + 1);
 
-            // Calculate elapsed time and display result
-            ticks = clock() - ticks; // current clock ticks minus starting clock ticks
-            cout << "time: " << ticks << " clock ticks" << endl;
-            cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+    // bids of the left run that already precede the right run stay put
+    int skip = gallopRight(&bids[base1], len1, bids[base2].title, stats);
+    base1 += skip;
+    len1 -= skip;
+    if (len1 == 0) {
+        return;
+    }
+    // and so do bids of the right run that follow the left run
+    len2 = gallopLeft(&bids[base2], len2, bids[base1 + len1 - 1].title, stats);
+    if (len2 == 0) {
+        return;
+    }
 
-            break;
+    vector<Bid>& tmp = state.tmp;
+    tmp.resize(len1);
+    move(bids.begin() + base1, bids.begin() + base2, tmp.begin());
+    stats.Move(len1);
 
-        case 2:
-            // Loop and display the bids read
-            for (int i = 0; i < bids.size(); ++i) {
-                displayBid(bids[i]);
+    int a = 0;
+    int b = base2;
+    int bEnd = base2 + len2;
+    int dest = base1;
+    while (a < len1 && b < bEnd) {
+        // one bid at a time until one side wins minGallop times in a row
+        int winsA = 0;
+        int winsB = 0;
+        while (a < len1 && b < bEnd && winsA < state.minGallop && winsB < state.minGallop) {
+            stats.Move();
+            if (titleLess(bids[b].title, tmp[a].title, stats)) {
+                bids[dest++] = move(bids[b++]);
+                ++winsB;
+                winsA = 0;
+            } else {
+                bids[dest++] = move(tmp[a++]);
+                ++winsA;
+                winsB = 0;
             }
-            cout << endl;
+        }
+
+        // galloping: copy whole blocks found by exponential search
+        int countA, countB;
+        do {
+            if (a >= len1 || b >= bEnd) {
+                break;
+            }
+            countA = gallopRight(&tmp[a], len1 - a, bids[b].title, stats);
+            move(tmp.begin() + a, tmp.begin() + a + countA, bids.begin() + dest);
+            stats.Move(countA);
+            dest += countA;
+            a += countA;
+            if (a >= len1) {
+                break;
+            }
+            countB = gallopLeft(&bids[b], bEnd - b, tmp[a].title, stats);
+            move(bids.begin() + b, bids.begin() + b + countB, bids.begin() + dest);
+            stats.Move(countB);
+            dest += countB;
+            b += countB;
+            if (state.minGallop > 1) {
+                --state.minGallop;
+            }
+        } while (countA >= MERGE_MIN_GALLOP || countB >= MERGE_MIN_GALLOP);
+        state.minGallop += 2; // galloping stopped paying off
+    }
+
+    // whatever is left of the left run fills the gap before the right run
+    move(tmp.begin() + a, tmp.begin() + len1, bids.begin() + dest);
+    stats.Move(len1 - a);
+}
+
+/**
+ * Merge pending runs until the run lengths on the stack shrink at
+ * least as fast as the Fibonacci numbers, keeping merges balanced
+ */
+template <typename Stats>
+void mergeCollapse(vector<Bid>& bids, MergeState& state, Stats& stats) {
+    vector<pair<int, int>>& runs = state.runs;
+    while (runs.size() > 1) {
+        int n = runs.size() - 2;
+        if ((n > 0 && runs[n - 1].second <= runs[n].second + runs[n + 1].second)
+                || (n > 1 && runs[n - 2].second <= runs[n - 1].second + runs[n].second)) {
+            if (runs[n - 1].second < runs[n + 1].second) {
+                --n;
+            }
+            mergeAt(bids, state, n, stats);
+        } else if (runs[n].second <= runs[n + 1].second) {
+            mergeAt(bids, state, n, stats);
+        } else {
             break;
-        case 3:
-            ticks = clock();
-            selectionSort(bids);
-            ticks = clock() - ticks;
-            cout << "Selection sort completed in " << ticks << " clock ticks." << endl;
-            cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
-            break;  
-        case 4:
-            ticks = clock();
-            quickSort(bids, 0, bids.size() - 1);
-            ticks = clock() - ticks;
-            cout << "Quick sort completed in " << ticks << " clock ticks." << endl;
-            cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
-            break;  
+        }
+    }
+}
+
+/**
+ * Adaptive, stable natural merge sort by title. Existing ascending and
+ * descending runs are detected and merged with galloping, so presorted
+ * or appended-to-sorted inputs sort in close to linear time.
+ */
+template <typename Stats>
+void naturalMergeSort(vector<Bid>& bids, Stats& stats) {
+    int n = bids.size();
+    if (n < 2) {
+        return;
+    }
+
+    MergeState state;
+    int minRun = minRunLength(n);
+    int lo = 0;
+    while (lo < n) {
+        int runLen = countRun(bids, lo, n, stats);
+        if (runLen < minRun) {
+            // extend short runs so merges stay balanced
+            int forced = min(minRun, n - lo);
+            binaryInsertionSort(bids, lo, lo + forced, lo + runLen, stats);
+            runLen = forced;
+        }
+        state.runs.push_back(make_pair(lo, runLen));
+        mergeCollapse(bids, state, stats);
+        lo += runLen;
+    }
+
+    while (state.runs.size() > 1) {
+        int i = state.runs.size() - 2;
+        if (i > 0 && state.runs[i - 1].second < state.runs[i + 1].second) {
+            --i;
+        }
+        mergeAt(bids, state, i, stats);
+    }
+}
+
+void naturalMergeSort(vector<Bid>& bids) {
+    NoSortStats stats;
+    naturalMergeSort(bids, stats);
+}
+
+//============================================================================
+// Block quick sort over precomputed integer title prefixes
+//============================================================================
+
+/**
+ * A bid's sort key: the first 8 title bytes packed big-endian so that
+ * integer order matches string order, plus the bid's position
+ */
+struct SortKey {
+    uint64_t prefix;
+    uint32_t index;
+};
+
+/**
+ * Pack the first 8 bytes of a title into an order-preserving integer
+ */
+uint64_t titlePrefix(const string& title) {
+    uint64_t prefix = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        unsigned char ch = i < title.size() ? title[i] : 0;
+        prefix = (prefix << 8) | ch;
+    }
+    return prefix;
+}
+
+/**
+ * Sort a small range of keys by prefix with insertion sort
+ */
+template <typename Stats>
+void insertionSortKeys(vector<SortKey>& keys, int begin, int end, Stats& stats) {
+    for (int i = begin + 1; i <= end; ++i) {
+        SortKey key = keys[i];
+        int j = i - 1;
+        while (j >= begin && (stats.Compare(), key.prefix < keys[j].prefix)) {
+            keys[j + 1] = keys[j];
+            --j;
+        }
+        keys[j + 1] = key;
+        stats.Move(i - j + 1);
+    }
+}
+
+// compare-exchanges performed by the 16-key sorting network: eleven
+// register-wide exchanges of four lanes, and eight in-register bitonic
+// steps of two shuffles with two lane pairs each
+const int SORT_NETWORK_COMPARATORS = 11 * 4 + 8 * 2 * 2;
+
+#ifdef SORT_NETWORK_AVX2
+
+/**
+ * Compare-exchange of four lane pairs: afterwards each lane of a holds
+ * the smaller prefix and b the larger, with the indexes following along
+ */
+__attribute__((target("avx2")))
+inline void networkExchange(__m256i& a, __m256i& b, __m256i& ia, __m256i& ib) {
+    __m256i swapMask = _mm256_cmpgt_epi64(a, b);
+    __m256i lo = _mm256_blendv_epi8(a, b, swapMask);
+    __m256i hi = _mm256_blendv_epi8(b, a, swapMask);
+    __m256i ilo = _mm256_blendv_epi8(ia, ib, swapMask);
+    __m256i ihi = _mm256_blendv_epi8(ib, ia, swapMask);
+    a = lo;
+    b = hi;
+    ia = ilo;
+    ib = ihi;
+}
+
+/**
+ * Compare-exchange within one register between lanes `distance` apart,
+ * keeping the smaller prefix in the lower lane of each pair
+ */
+template <int Shuffle, int UpperLanes>
+__attribute__((target("avx2")))
+inline void networkExchangeLanes(__m256i& v, __m256i& iv) {
+    __m256i other = _mm256_permute4x64_epi64(v, Shuffle);
+    __m256i iother = _mm256_permute4x64_epi64(iv, Shuffle);
+    // a lane takes its partner when it is in the lower half of its pair
+    // and the partner is smaller, or in the upper half and it is larger
+    __m256i greater = _mm256_cmpgt_epi64(v, other);
+    __m256i less = _mm256_cmpgt_epi64(other, v);
+    __m256i upper = _mm256_blend_epi32(_mm256_setzero_si256(), _mm256_set1_epi32(-1), UpperLanes);
+    __m256i take = _mm256_blendv_epi8(greater, less, upper);
+    v = _mm256_blendv_epi8(v, other, take);
+    iv = _mm256_blendv_epi8(iv, iother, take);
+}
+
+/**
+ * Sort a bitonic register of four keys
+ */
+__attribute__((target("avx2")))
+inline void networkBitonicSort4(__m256i& v, __m256i& iv) {
+    networkExchangeLanes<0x4E, 0xF0>(v, iv); // lanes 0-2, 1-3
+    networkExchangeLanes<0xB1, 0xCC>(v, iv); // lanes 0-1, 2-3
+}
+
+/**
+ * Merge two sorted registers into eight sorted keys held in a then b
+ */
+__attribute__((target("avx2")))
+inline void networkMerge4(__m256i& a, __m256i& b, __m256i& ia, __m256i& ib) {
+    b = _mm256_permute4x64_epi64(b, 0x1B);
+    ib = _mm256_permute4x64_epi64(ib, 0x1B);
+    networkExchange(a, b, ia, ib);
+    networkBitonicSort4(a, ia);
+    networkBitonicSort4(b, ib);
+}
+
+/**
+ * Transpose a 4x4 matrix of 64-bit lanes held in four registers
+ */
+__attribute__((target("avx2")))
+inline void networkTranspose(__m256i& r0, __m256i& r1, __m256i& r2, __m256i& r3) {
+    __m256i t0 = _mm256_unpacklo_epi64(r0, r1);
+    __m256i t1 = _mm256_unpackhi_epi64(r0, r1);
+    __m256i t2 = _mm256_unpacklo_epi64(r2, r3);
+    __m256i t3 = _mm256_unpackhi_epi64(r2, r3);
+    r0 = _mm256_permute2x128_si256(t0, t2, 0x20);
+    r1 = _mm256_permute2x128_si256(t1, t3, 0x20);
+    r2 = _mm256_permute2x128_si256(t0, t2, 0x31);
+    r3 = _mm256_permute2x128_si256(t1, t3, 0x31);
+}
+
+/**
+ * Sort exactly 16 keys by prefix with a vectorized sorting network: a
+ * 4-input network sorts the columns of four registers, a transpose
+ * turns the columns into sorted runs of four, and bitonic merges
+ * combine the runs. Keys are loaded two per register and split into
+ * prefix and index registers; the input order does not matter.
+ */
+__attribute__((target("avx2")))
+void sortNetwork16(SortKey* keys) {
+    static_assert(sizeof(SortKey) == 16, "SortKey must pack into two 64-bit lanes");
+    __m256i* lanes = reinterpret_cast<__m256i*>(keys);
+    // flipping the sign bit lets signed 64-bit compares order the prefixes
+    __m256i bias = _mm256_set1_epi64x(INT64_MIN);
+
+    __m256i r[4], ir[4];
+    for (int i = 0; i < 4; ++i) {
+        __m256i v0 = _mm256_loadu_si256(lanes + 2 * i);
+        __m256i v1 = _mm256_loadu_si256(lanes + 2 * i + 1);
+        r[i] = _mm256_xor_si256(_mm256_unpacklo_epi64(v0, v1), bias);
+        ir[i] = _mm256_unpackhi_epi64(v0, v1);
+    }
+
+    // optimal 4-input network applied to every column at once
+    networkExchange(r[0], r[1], ir[0], ir[1]);
+    networkExchange(r[2], r[3], ir[2], ir[3]);
+    networkExchange(r[0], r[2], ir[0], ir[2]);
+    networkExchange(r[1], r[3], ir[1], ir[3]);
+    networkExchange(r[1], r[2], ir[1], ir[2]);
+    networkTranspose(r[0], r[1], r[2], r[3]);
+    networkTranspose(ir[0], ir[1], ir[2], ir[3]);
+
+    // two merges of 4+4, then one bitonic merge of 8+8
+    networkMerge4(r[0], r[1], ir[0], ir[1]);
+    networkMerge4(r[2], r[3], ir[2], ir[3]);
+    __m256i high = _mm256_permute4x64_epi64(r[3], 0x1B);
+    __m256i ihigh = _mm256_permute4x64_epi64(ir[3], 0x1B);
+    r[3] = _mm256_permute4x64_epi64(r[2], 0x1B);
+    ir[3] = _mm256_permute4x64_epi64(ir[2], 0x1B);
+    r[2] = high;
+    ir[2] = ihigh;
+    networkExchange(r[0], r[2], ir[0], ir[2]);
+    networkExchange(r[1], r[3], ir[1], ir[3]);
+    networkExchange(r[0], r[1], ir[0], ir[1]);
+    networkExchange(r[2], r[3], ir[2], ir[3]);
+
+    for (int i = 0; i < 4; ++i) {
+        networkBitonicSort4(r[i], ir[i]);
+        // reorder lanes to 0,2,1,3 so the unpacks rebuild keys in order
+        __m256i prefix = _mm256_permute4x64_epi64(_mm256_xor_si256(r[i], bias), 0xD8);
+        __m256i index = _mm256_permute4x64_epi64(ir[i], 0xD8);
+        _mm256_storeu_si256(lanes + 2 * i, _mm256_unpacklo_epi64(prefix, index));
+        _mm256_storeu_si256(lanes + 2 * i + 1, _mm256_unpackhi_epi64(prefix, index));
+    }
+}
+
+/**
+ * True when the CPU running the program supports AVX2
+ */
+bool sortNetworkAvailable() {
+    static const bool available = __builtin_cpu_supports("avx2");
+    return available;
+}
+
+#endif
+
+/**
+ * Sort a leaf partition of at most BLOCK_SORT_LEAF_MAX keys. With AVX2
+ * the network sorts a full 16-key window around the leaf: every key
+ * right of a quick sort partition is at least as large as the keys in
+ * it, and every key left of it at most as large, so sorting a window
+ * that spills into a neighbour leaves the neighbour's keys in place
+ * relative to the leaf and sorted among themselves if they already were.
+ */
+template <typename Stats>
+void sortLeafKeys(vector<SortKey>& keys, int begin, int end, Stats& stats) {
+#ifdef SORT_NETWORK_AVX2
+    if (end > begin && keys.size() >= 16 && sortNetworkAvailable()) {
+        int window = min(begin, (int) keys.size() - 16);
+        sortNetwork16(&keys[window]);
+        stats.Compare(SORT_NETWORK_COMPARATORS);
+        return;
+    }
+#endif
+    insertionSortKeys(keys, begin, end, stats);
+}
+
+/**
+ * BlockQuicksort partition. Each pass scans a block from both ends and
+ * records the offsets of misplaced keys with branch-free increments,
+ * then swaps the recorded pairs in a second loop, so the comparisons
+ * never feed a conditional jump.
+ *
+ * @return final position of the pivot
+ */
+template <typename Stats>
+int blockPartition(vector<SortKey>& keys, int begin, int end, Stats& stats) {
+    // median of first, middle and last (end is inclusive) moved to the
+    // end as the pivot
+    int a = begin;
+    int b = begin + (end - begin) / 2;
+    int c = end;
+    if (keys[b].prefix < keys[a].prefix) {
+        swap(a, b);
+    }
+    if (keys[c].prefix < keys[b].prefix) {
+        swap(b, c);
+        if (keys[b].prefix < keys[a].prefix) {
+            swap(a, b);
+        }
+    }
+    swap(keys[b], keys[end]);
+    stats.Compare(3);
+    stats.Swap();
+    uint64_t pivot = keys[end].prefix;
+
+    unsigned char offsetsL[PARTITION_BLOCK_SIZE];
+    unsigned char offsetsR[PARTITION_BLOCK_SIZE];
+    int numL = 0, numR = 0, startL = 0, startR = 0;
+    int l = begin;
+    int r = end - 1;
+
+    while (r - l + 1 > 2 * PARTITION_BLOCK_SIZE) {
+        if (numL == 0) {
+            startL = 0;
+            for (int i = 0; i < PARTITION_BLOCK_SIZE; ++i) {
+                offsetsL[numL] = i;
+                numL += keys[l + i].prefix >= pivot;
+            }
+            stats.Compare(PARTITION_BLOCK_SIZE);
+        }
+        if (numR == 0) {
+            startR = 0;
+            for (int i = 0; i < PARTITION_BLOCK_SIZE; ++i) {
+                offsetsR[numR] = i;
+                numR += keys[r - i].prefix <= pivot;
+            }
+            stats.Compare(PARTITION_BLOCK_SIZE);
+        }
+
+        int num = min(numL, numR);
+        for (int j = 0; j < num; ++j) {
+            swap(keys[l + offsetsL[startL + j]], keys[r - offsetsR[startR + j]]);
+        }
+        stats.Swap(num);
+        numL -= num;
+        numR -= num;
+        startL += num;
+        startR += num;
+        if (numL == 0) {
+            l += PARTITION_BLOCK_SIZE;
+        }
+        if (numR == 0) {
+            r -= PARTITION_BLOCK_SIZE;
+        }
+    }
+
+    // finish the unscanned middle, including any half-used block
+    for (int i = l; i <= r; ++i) {
+        stats.Compare();
+        if (keys[i].prefix < pivot) {
+            swap(keys[i], keys[l]);
+            stats.Swap();
+            ++l;
+        }
+    }
+    swap(keys[l], keys[end]);
+    stats.Swap();
+    stats.Split(l - begin, end - l);
+    return l;
+}
+
+/**
+ * Quick sort of the keys by prefix using the block partition
+ */
+template <typename Stats>
+void blockQuickSortKeys(vector<SortKey>& keys, int begin, int end, Stats& stats, int depth = 1) {
+    stats.Depth(depth);
+    while (end - begin + 1 > BLOCK_SORT_LEAF_MAX) {
+        int mid = blockPartition(keys, begin, end, stats);
+        // recurse into the smaller side to bound the stack depth
+        if (mid - begin < end - mid) {
+            blockQuickSortKeys(keys, begin, mid - 1, stats, depth + 1);
+            begin = mid + 1;
+        } else {
+            blockQuickSortKeys(keys, mid + 1, end, stats, depth + 1);
+            end = mid - 1;
+        }
+    }
+    sortLeafKeys(keys, begin, end, stats);
+}
+
+void blockQuickSortKeys(vector<SortKey>& keys, int begin, int end) {
+    NoSortStats stats;
+    blockQuickSortKeys(keys, begin, end, stats);
+}
+
+/**
+ * Sort bids by title: block quick sort the packed prefixes, break ties
+ * between equal prefixes on the full title, then move each bid once
+ */
+template <typename Stats>
+void blockQuickSort(vector<Bid>& bids, Stats& stats) {
+    vector<SortKey> keys(bids.size());
+    for (size_t i = 0; i < bids.size(); ++i) {
+        keys[i].prefix = titlePrefix(bids[i].title);
+        keys[i].index = i;
+    }
+    blockQuickSortKeys(keys, 0, (int) keys.size() - 1, stats);
+
+    // titles longer than the prefix are ordered within equal-prefix groups
+    for (size_t first = 0; first < keys.size(); ) {
+        size_t last = first + 1;
+        while (last < keys.size() && keys[last].prefix == keys[first].prefix) {
+            ++last;
+        }
+        if (last - first > 1) {
+            sort(keys.begin() + first, keys.begin() + last,
+                    [&](const SortKey& a, const SortKey& b) {
+                        return titleLess(bids[a.index].title, bids[b.index].title, stats);
+                    });
+        }
+        first = last;
+    }
+
+    vector<Bid> sorted;
+    sorted.reserve(bids.size());
+    for (const SortKey& key : keys) {
+        sorted.push_back(move(bids[key.index]));
+    }
+    bids.swap(sorted);
+    stats.Move(bids.size());
+}
+
+void blockQuickSort(vector<Bid>& bids) {
+    NoSortStats stats;
+    blockQuickSort(bids, stats);
+}
+
+//============================================================================
+// LSD radix sort for numeric columns
+//============================================================================
+
+/**
+ * Numeric columns the radix sort can order by
+ */
+enum NumericColumn {
+    BY_AMOUNT,
+    BY_AUCTION_ID
+};
+
+/**
+ * Map a double to an unsigned integer with the same ordering: flip all
+ * bits of negatives, and only the sign bit of positives
+ */
+uint64_t orderedBits(double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return (bits & 0x8000000000000000ULL) ? ~bits : bits | 0x8000000000000000ULL;
+}
+
+/**
+ * Radix key of a bid for the given column; auction IDs that are not
+ * numeric sort after all numeric ones
+ */
+uint64_t numericKey(const Bid& bid, NumericColumn column) {
+    if (column == BY_AMOUNT) {
+        return orderedBits(bid.amount);
+    }
+    if (bid.bidId.empty() || bid.bidId.size() > 19
+            || bid.bidId.find_first_not_of("0123456789") != string::npos) {
+        return UINT64_MAX;
+    }
+    return stoull(bid.bidId);
+}
+
+/**
+ * Stable LSD radix sort of bids by a numeric column. The keys and bid
+ * indexes are kept in separate arrays that ping-pong between two
+ * buffers on every 11-bit pass, so the bids themselves move only once;
+ * passes whose digit is the same for every key are skipped.
+ *
+ * @param bids the bids to sort
+ * @param column the numeric column to order by
+ */
+template <typename Stats>
+void radixSort(vector<Bid>& bids, NumericColumn column, Stats& stats) {
+    size_t n = bids.size();
+    vector<uint64_t> keys(n), keysTmp(n);
+    vector<uint32_t> index(n), indexTmp(n);
+
+    // one scan builds the histograms of every pass
+    vector<size_t> counts(RADIX_PASSES * RADIX_BUCKETS, 0);
+    for (size_t i = 0; i < n; ++i) {
+        keys[i] = numericKey(bids[i], column);
+        index[i] = i;
+        for (int pass = 0; pass < RADIX_PASSES; ++pass) {
+            ++counts[pass * RADIX_BUCKETS + ((keys[i] >> (pass * RADIX_BITS)) & (RADIX_BUCKETS - 1))];
+        }
+    }
+
+    for (int pass = 0; pass < RADIX_PASSES; ++pass) {
+        size_t* count = &counts[pass * RADIX_BUCKETS];
+        int shift = pass * RADIX_BITS;
+        if (n == 0 || count[(keys[0] >> shift) & (RADIX_BUCKETS - 1)] == n) {
+            continue; // every key has the same digit
+        }
+
+        // turn counts into starting offsets
+        size_t offset = 0;
+        for (int bucket = 0; bucket < RADIX_BUCKETS; ++bucket) {
+            size_t bucketCount = count[bucket];
+            count[bucket] = offset;
+            offset += bucketCount;
+        }
+
+        for (size_t i = 0; i < n; ++i) {
+            size_t dest = count[(keys[i] >> shift) & (RADIX_BUCKETS - 1)]++;
+            keysTmp[dest] = keys[i];
+            indexTmp[dest] = index[i];
+        }
+        keys.swap(keysTmp);
+        index.swap(indexTmp);
+        stats.Move(n);
+    }
+
+    vector<Bid> sorted;
+    sorted.reserve(n);
+    for (uint32_t i : index) {
+        sorted.push_back(move(bids[i]));
+    }
+    bids.swap(sorted);
+    stats.Move(n);
+}
+
+void radixSort(vector<Bid>& bids, NumericColumn column) {
+    NoSortStats stats;
+    radixSort(bids, column, stats);
+}
+
+template <typename Stats>
+void selectionSort(vector<Bid>& bids, Stats& stats) {
+    size_t size = bids.size();
+    for (size_t pos = 0; pos < size - 1; ++pos) {
+        size_t min = pos;
+        for (size_t j = pos + 1; j < size; ++j) {
+            if (titleLess(bids[j].title, bids[min].title, stats)) {
+                min = j;
+            }
+        }
+        if (min != pos) {
+            swapBids(bids[pos], bids[min], stats);
+        }
+    }
+}
+
+void selectionSort(vector<Bid>& bids) {
+    NoSortStats stats;
+    selectionSort(bids, stats);
+}
+
+
+//============================================================================
+// Sorted order maintained under incremental inserts
+//============================================================================
+
+/**
+ * Title order of a bid vector that is kept current as bids are added,
+ * instead of re-sorting the whole vector. New bids only ever go to the
+ * back of the vector; order[i] is the position of the i-th bid by title.
+ * While the index is dirty (after a load or a sort by another key) no
+ * order is kept and adding bids costs nothing extra.
+ */
+class SortedBidIndex {
+
+public:
+    explicit SortedBidIndex(vector<Bid>& bids) : bids(bids) {}
+
+    /**
+     * Whether a full sort is needed before the title order is known
+     */
+    bool Dirty() const {
+        return dirty;
+    }
+
+    /**
+     * Forget the order, e.g. after the vector was replaced or reordered
+     */
+    void MarkDirty() {
+        dirty = true;
+        order.clear();
+    }
+
+    /**
+     * Record that a sort just finished
+     *
+     * @param byTitle false if the bids were ordered by another key
+     */
+    void MarkSorted(bool byTitle) {
+        if (!byTitle) {
+            MarkDirty();
+            return;
+        }
+        order.resize(bids.size());
+        for (size_t i = 0; i < order.size(); ++i) {
+            order[i] = i;
+        }
+        dirty = false;
+    }
+
+    /**
+     * Add one bid: binary search for its place (after equal titles),
+     * then shift the tail of the index array up one slot
+     */
+    void Insert(Bid bid) {
+        bids.push_back(move(bid));
+        if (dirty) {
+            return;
+        }
+        uint32_t added = bids.size() - 1;
+        size_t pos = upper_bound(order.begin(), order.end(), added, [this](uint32_t a, uint32_t b) {
+            return bids[a].title < bids[b].title;
+        }) - order.begin();
+        order.insert(order.begin() + pos, added);
+    }
+
+    /**
+     * Add a batch of bids: sort the batch on its own, then merge it into
+     * the index in one linear pass, O(k log k + n)
+     */
+    void InsertBatch(vector<Bid> batch) {
+        uint32_t first = bids.size();
+        move(batch.begin(), batch.end(), back_inserter(bids));
+        if (dirty) {
+            return;
+        }
+        auto byTitle = [this](uint32_t a, uint32_t b) {
+            return bids[a].title < bids[b].title;
+        };
+
+        vector<uint32_t> added(batch.size());
+        for (size_t i = 0; i < added.size(); ++i) {
+            added[i] = first + i;
+        }
+        stable_sort(added.begin(), added.end(), byTitle);
+
+        vector<uint32_t> merged(order.size() + added.size());
+        merge(order.begin(), order.end(), added.begin(), added.end(), merged.begin(), byTitle);
+        order.swap(merged);
+    }
+
+    /**
+     * Move the bids into title order in one O(n) pass
+     */
+    void Gather() {
+        if (dirty) {
+            return;
+        }
+        vector<Bid> sorted;
+        sorted.reserve(bids.size());
+        for (uint32_t i : order) {
+            sorted.push_back(move(bids[i]));
+        }
+        bids.swap(sorted);
+        MarkSorted(true);
+    }
+
+    /**
+     * The i-th bid by title; only valid while the index is clean
+     */
+    const Bid& At(size_t i) const {
+        return bids[order[i]];
+    }
+
+private:
+    vector<Bid>& bids;
+    vector<uint32_t> order;
+    bool dirty = true;
+};
+
+//============================================================================
+// Top-K query by winning bid amount
+//============================================================================
+
+/**
+ * Heap ordering that keeps the smallest amount at the front,
+ * so the heap holds the k largest bids seen so far
+ */
+bool amountGreater(const Bid& a, const Bid& b) {
+    return a.amount > b.amount;
+}
+
+/**
+ * Offer one bid to a bounded min-heap of at most k entries
+ *
+ * @param heap the heap of the current top bids
+ * @param bid the candidate bid
+ * @param k the heap capacity
+ */
+void offerTopK(vector<Bid>& heap, const Bid& bid, size_t k) {
+    if (heap.size() < k) {
+        heap.push_back(bid);
+        push_heap(heap.begin(), heap.end(), amountGreater);
+    } else if (bid.amount > heap.front().amount) {
+        // evict the smallest of the current top bids
+        pop_heap(heap.begin(), heap.end(), amountGreater);
+        heap.back() = bid;
+        push_heap(heap.begin(), heap.end(), amountGreater);
+    }
+}
+
+/**
+ * Collect the k highest bids of one chunk in O(n log k)
+ *
+ * @param bids the full bid vector
+ * @param begin first index of the chunk
+ * @param end one past the last index of the chunk
+ * @param k number of bids to keep
+ * @param fund only consider bids from this fund (empty for all)
+ * @param heap receives the chunk's top bids as a min-heap
+ */
+void topKChunk(const vector<Bid>& bids, size_t begin, size_t end, size_t k,
+        const string& fund, vector<Bid>& heap) {
+    heap.reserve(min(k, end - begin));
+    for (size_t i = begin; i < end; ++i) {
+        if (fund.empty() || bids[i].fund == fund) {
+            offerTopK(heap, bids[i], k);
+        }
+    }
+}
+
+/**
+ * Find the k highest winning bids, optionally limited to one fund.
+ * Large inputs are split into chunks scanned on separate threads,
+ * then the per-chunk heaps are merged into the final result.
+ *
+ * @param bids the bids to search
+ * @param k number of bids to return
+ * @param fund only consider bids from this fund (empty for all)
+ * @return the top k bids ordered from highest to lowest amount
+ */
+vector<Bid> topKBids(const vector<Bid>& bids, size_t k, const string& fund) {
+    vector<Bid> result;
+    if (k == 0 || bids.empty()) {
+        return result;
+    }
+
+    size_t chunks = max<size_t>(1, thread::hardware_concurrency());
+    chunks = min(chunks, max<size_t>(1, bids.size() / TOPK_CHUNK_MIN));
+    size_t chunkSize = (bids.size() + chunks - 1) / chunks;
+
+    vector<vector<Bid>> partials(chunks);
+    if (chunks == 1) {
+        topKChunk(bids, 0, bids.size(), k, fund, partials[0]);
+    } else {
+        vector<thread> workers;
+        for (size_t c = 0; c < chunks; ++c) {
+            size_t begin = c * chunkSize;
+            size_t end = min(bids.size(), begin + chunkSize);
+            workers.emplace_back(topKChunk, cref(bids), begin, end, k,
+                    cref(fund), ref(partials[c]));
+        }
+        for (thread& worker : workers) {
+            worker.join();
+        }
+    }
+
+    // merge the partial heaps; at most chunks * k bids are offered here
+    result.swap(partials[0]);
+    for (size_t c = 1; c < chunks; ++c) {
+        for (const Bid& bid : partials[c]) {
+            offerTopK(result, bid, k);
+        }
+    }
+    sort_heap(result.begin(), result.end(), amountGreater);
+    return result;
+}
+
+
+//============================================================================
+// External merge sort for bid files larger than memory
+//============================================================================
+
+/**
+ * Settings for the external sort pipeline
+ */
+struct ExternalSortConfig {
+    size_t memoryBudget = EXTERNAL_SORT_BUDGET_MB * 1024 * 1024; // bytes
+    string tempDir = EXTERNAL_SORT_TEMP_DIR;
+};
+
+/**
+ * One CSV row carried through the external sort: the title is the
+ * sort key and the raw line is written back out unchanged
+ */
+struct RunRecord {
+    string title;
+    string line;
+};
+
+/**
+ * Write a length-prefixed string to a binary run file
+ */
+void writeRunString(ofstream& out, const string& str) {
+    uint32_t length = str.size();
+    out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+    out.write(str.data(), length);
+}
+
+/**
+ * Read a length-prefixed string from a binary run file
+ *
+ * @return false at the end of the run
+ */
+bool readRunString(ifstream& in, string& str) {
+    uint32_t length = 0;
+    if (!in.read(reinterpret_cast<char*>(&length), sizeof(length))) {
+        return false;
+    }
+    str.resize(length);
+    return static_cast<bool>(in.read(&str[0], length));
+}
+
+/**
+ * Parse the buffered lines of one run, sort them by title and spill
+ * them to a temporary binary file
+ *
+ * @param header the CSV header line
+ * @param lines the raw data lines of this run
+ * @param runPath the temporary file to write
+ */
+void spillRun(const string& header, vector<string>& lines, const string& runPath) {
+    string text = header + "\n";
+    for (const string& line : lines) {
+        text += line;
+        text += "\n";
+    }
+
+    // reuse the CSV parser on the buffered text to pull out the titles
+    vector<RunRecord> records;
+    records.reserve(lines.size());
+    {
+        csv::Parser run = csv::Parser(text, csv::ePURE);
+        text.clear();
+        for (unsigned int i = 0; i < run.rowCount(); i++) {
+            RunRecord record;
+            record.title = run[i][0];
+            record.line.swap(lines[i]);
+            records.push_back(move(record));
+        }
+    }
+    lines.clear();
+
+    stable_sort(records.begin(), records.end(),
+            [](const RunRecord& a, const RunRecord& b) { return a.title < b.title; });
+
+    ofstream out(runPath, ios::binary);
+    if (!out) {
+        throw csv::Error("Failed to create " + runPath);
+    }
+    for (const RunRecord& record : records) {
+        writeRunString(out, record.title);
+        writeRunString(out, record.line);
+    }
+}
+
+/**
+ * The run files of one sort, removed when it finishes or throws
+ */
+struct RunFiles {
+    vector<string> paths;
+
+    RunFiles() {}
+    RunFiles(const RunFiles&) = delete;
+    RunFiles& operator=(const RunFiles&) = delete;
+
+    ~RunFiles() {
+        for (const string& path : paths) {
+            remove(path.c_str());
+        }
+    }
+};
+
+/**
+ * A run file name prefix no other sort uses at the same time: the time,
+ * the process id and a per-process count
+ */
+string runFilePrefix(const string& tempDir) {
+    static atomic<unsigned> sorts(0);
+    string prefix = tempDir + "/ebid_run_" + to_string(time(nullptr)) + "_";
+#ifdef __linux__
+    prefix += to_string(getpid()) + "_";
+#endif
+    return prefix + to_string(sorts++) + "_";
+}
+
+/**
+ * Sequential reader over one spilled run
+ */
+struct RunReader {
+    ifstream in;
+    RunRecord current;
+    bool exhausted = false;
+
+    void open(const string& runPath) {
+        in.open(runPath, ios::binary);
+        advance();
+    }
+
+    void advance() {
+        exhausted = !(readRunString(in, current.title) && readRunString(in, current.line));
+    }
+};
+
+/**
+ * Loser tree over k sorted runs. Internal nodes remember the loser of
+ * each match so replacing the winner replays only one root path,
+ * costing log k comparisons per output record.
+ */
+class LoserTree {
+
+private:
+    vector<RunReader>& runs;
+    vector<int> tree; // tree[0] holds the overall winner
+    int k;
+
+    // true if run a should be output before run b (ties keep run order)
+    bool beats(int a, int b) const {
+        if (runs[a].exhausted) {
+            return false;
+        }
+        if (runs[b].exhausted) {
+            return true;
+        }
+        if (runs[a].current.title != runs[b].current.title) {
+            return runs[a].current.title < runs[b].current.title;
+        }
+        return a < b;
+    }
+
+public:
+    LoserTree(vector<RunReader>& aRuns) : runs(aRuns), k(aRuns.size()) {
+        // leaves live at k..2k-1, internal nodes at 1..k-1
+        vector<int> winner(2 * k);
+        tree.assign(k, 0);
+        for (int i = 0; i < k; ++i) {
+            winner[k + i] = i;
+        }
+        for (int node = k - 1; node >= 1; --node) {
+            int left = winner[2 * node];
+            int right = winner[2 * node + 1];
+            if (beats(left, right)) {
+                winner[node] = left;
+                tree[node] = right;
+            } else {
+                winner[node] = right;
+                tree[node] = left;
+            }
+        }
+        tree[0] = winner[1];
+    }
+
+    int Winner() const {
+        return tree[0];
+    }
+
+    // call after the winning run has advanced to its next record
+    void Replay() {
+        int current = tree[0];
+        for (int node = (current + k) / 2; node >= 1; node /= 2) {
+            if (beats(tree[node], current)) {
+                swap(tree[node], current);
+            }
+        }
+        tree[0] = current;
+    }
+};
+
+/**
+ * Sort a bid CSV of any size by title into a new CSV file. The input is
+ * streamed in runs that fit the memory budget, each run is sorted and
+ * spilled to a temporary binary file, and the runs are k-way merged.
+ *
+ * @param csvPath the CSV file to sort
+ * @param outputPath the sorted CSV file to write
+ * @param config memory budget and temporary directory
+ * @return the number of bids written
+ */
+size_t externalSortBids(const string& csvPath, const string& outputPath,
+        const ExternalSortConfig& config) {
+    ifstream in(csvPath);
+    if (!in) {
+        throw csv::Error("Failed to open " + csvPath);
+    }
+
+    string header;
+    getline(in, header);
+
+    // raw text is roughly a quarter of what a run costs once parsed and sorted
+    size_t runBytes = max<size_t>(1, config.memoryBudget / 4);
+    string runPrefix = runFilePrefix(config.tempDir);
+    RunFiles runFiles; // declared before the readers so they close first
+    vector<string>& runPaths = runFiles.paths;
+
+    vector<string> lines;
+    size_t bytes = 0;
+    string line;
+    while (getline(in, line)) {
+        if (line.empty()) {
+            continue;
+        }
+        bytes += line.size() + sizeof(string);
+        lines.push_back(move(line));
+        if (bytes >= runBytes) {
+            runPaths.push_back(runPrefix + to_string(runPaths.size()) + ".bin");
+            spillRun(header, lines, runPaths.back());
+            bytes = 0;
+        }
+    }
+    if (!lines.empty()) {
+        runPaths.push_back(runPrefix + to_string(runPaths.size()) + ".bin");
+        spillRun(header, lines, runPaths.back());
+    }
+
+    ofstream out(outputPath);
+    if (!out) {
+        throw csv::Error("Failed to create " + outputPath);
+    }
+    out << header << "\n";
+
+    size_t written = 0;
+    if (!runPaths.empty()) {
+        vector<RunReader> runs(runPaths.size());
+        for (size_t i = 0; i < runPaths.size(); ++i) {
+            runs[i].open(runPaths[i]);
+        }
+
+        LoserTree tree(runs);
+        while (!runs[tree.Winner()].exhausted) {
+            RunReader& run = runs[tree.Winner()];
+            out << run.current.line << "\n";
+            ++written;
+            run.advance();
+            tree.Replay();
+        }
+    }
+
+    cout << runPaths.size() << " sorted runs merged" << endl;
+    return written;
+}
+
+
+//============================================================================
+// Collated title ordering
+//============================================================================
+
+/**
+ * Normalized sort key for a title: double quotes stripped, surrounding
+ * whitespace trimmed and ASCII letters folded to lower case, so that
+ * "Desk" and " desk" collate together
+ */
+string collationKey(const string& title) {
+    string key;
+    key.reserve(title.size() + 5);
+    for (char ch : title) {
+        if (ch != '"') {
+            key += (ch >= 'A' && ch <= 'Z') ? char(ch - 'A' + 'a') : ch;
+        }
+    }
+    size_t first = key.find_first_not_of(" \t\r\n");
+    if (first == string::npos) {
+        return string();
+    }
+    key.erase(key.find_last_not_of(" \t\r\n") + 1);
+    key.erase(0, first);
+    return key;
+}
+
+/**
+ * Run any title sort in collation order. Each bid's key is built once and
+ * swapped into its title for the duration of the sort, so the sorts
+ * compare plain strings as usual; the original titles wait in a side
+ * buffer. Every key ends in a NUL and the bid's big-endian position,
+ * which lets the titles be put back and makes the order stable even for
+ * unstable sorts.
+ *
+ * @param sortFn generic lambda taking (bids, stats)
+ */
+template <typename SortFn, typename Stats>
+void collatedSort(vector<Bid>& bids, SortFn sortFn, Stats& stats) {
+    vector<string> titles(bids.size());
+    for (size_t i = 0; i < bids.size(); ++i) {
+        string key = collationKey(bids[i].title);
+        key += '\0';
+        for (int shift = 24; shift >= 0; shift -= 8) {
+            key += char((i >> shift) & 0xff);
+        }
+        titles[i] = move(bids[i].title);
+        bids[i].title = move(key);
+    }
+
+    sortFn(bids, stats);
+
+    for (Bid& bid : bids) {
+        size_t i = 0;
+        for (size_t byte = bid.title.size() - 4; byte < bid.title.size(); ++byte) {
+            i = (i << 8) | (unsigned char)bid.title[byte];
+        }
+        bid.title = move(titles[i]);
+    }
+}
+
+//============================================================================
+// Parallel sort
+//============================================================================
+
+/**
+ * Sort bids by title on several threads: each thread block quick sorts
+ * one chunk, then neighbouring chunks are merged pairwise in parallel
+ * rounds. Each thread counts into its own stats, merged afterwards.
+ */
+template <typename Stats>
+void parallelSort(vector<Bid>& bids, Stats& stats) {
+    size_t chunks = max<size_t>(1, thread::hardware_concurrency());
+    chunks = min(chunks, max<size_t>(1, bids.size() / PARALLEL_SORT_MIN_CHUNK));
+    if (chunks == 1) {
+        blockQuickSort(bids, stats);
+        return;
+    }
+
+    vector<size_t> bounds;
+    for (size_t c = 0; c <= chunks; ++c) {
+        bounds.push_back(bids.size() * c / chunks);
+    }
+
+    vector<Stats> local(chunks);
+    vector<thread> workers;
+    for (size_t c = 0; c < chunks; ++c) {
+        workers.emplace_back([&bids, &bounds, &local, c]() {
+            vector<Bid> part(make_move_iterator(bids.begin() + bounds[c]),
+                    make_move_iterator(bids.begin() + bounds[c + 1]));
+            blockQuickSort(part, local[c]);
+            move(part.begin(), part.end(), bids.begin() + bounds[c]);
+        });
+    }
+    for (thread& worker : workers) {
+        worker.join();
+    }
+
+    // merge neighbouring sorted chunks until one remains
+    while (bounds.size() > 2) {
+        vector<size_t> merged;
+        workers.clear();
+        for (size_t c = 0; c + 1 < bounds.size(); c += 2) {
+            merged.push_back(bounds[c]);
+            if (c + 2 < bounds.size()) {
+                size_t first = bounds[c], middle = bounds[c + 1], last = bounds[c + 2];
+                Stats& counter = local[c / 2];
+                workers.emplace_back([&bids, &counter, first, middle, last]() {
+                    inplace_merge(bids.begin() + first, bids.begin() + middle, bids.begin() + last,
+                            [&counter](const Bid& a, const Bid& b) {
+                                return titleLess(a.title, b.title, counter);
+                            });
+                    counter.Move(last - first);
+                });
+            }
+        }
+        merged.push_back(bounds.back());
+        for (thread& worker : workers) {
+            worker.join();
+        }
+        bounds.swap(merged);
+    }
+
+    for (const Stats& counter : local) {
+        stats.Merge(counter);
+    }
+}
+
+void parallelSort(vector<Bid>& bids) {
+    NoSortStats stats;
+    parallelSort(bids, stats);
+}
+
+//============================================================================
+// Automatic sort selection
+//============================================================================
+
+/**
+ * Thresholds for choosing a sort, measured once on this host by
+ * calibrateSorts() and kept in SORT_CALIBRATION_FILE. Delete the file
+ * to recalibrate, e.g. after moving to different hardware.
+ */
+struct SortCalibration {
+    size_t insertionMax = 32;     // insertion sort up to this many bids
+    double presortedMin = 0.98;   // sampled in-order pairs for run merging
+    double duplicateMin = 0.5;    // sampled duplicate ratio for 3-way quick sort
+    size_t parallelMin = SIZE_MAX; // parallel sort from this many bids
+};
+
+/**
+ * Input statistics taken from an evenly spaced sample of the bids
+ */
+struct SortInputStats {
+    size_t size = 0;
+    double ascending = 0.0;  // share of sampled neighbours already in order
+    double descending = 0.0; // share of sampled neighbours in reverse order
+    double duplicates = 0.0; // 1 - distinct / sampled titles
+};
+
+/**
+ * The algorithms the automatic sort can dispatch to
+ */
+enum AutoSortChoice {
+    AUTO_INSERTION,
+    AUTO_RUN_MERGE,
+    AUTO_THREE_WAY,
+    AUTO_PARALLEL,
+    AUTO_BLOCK_QUICK,
+    AUTO_RADIX
+};
+
+const char* autoSortName(AutoSortChoice choice) {
+    switch (choice) {
+    case AUTO_INSERTION:
+        return "insertion sort";
+    case AUTO_RUN_MERGE:
+        return "natural merge sort";
+    case AUTO_THREE_WAY:
+        return "three-way quick sort";
+    case AUTO_PARALLEL:
+        return "parallel sort";
+    case AUTO_RADIX:
+        return "radix sort";
+    default:
+        return "block quick sort";
+    }
+}
+
+/**
+ * Sample presortedness and duplicates of the titles in O(samples)
+ */
+SortInputStats sampleSortInput(const vector<Bid>& bids) {
+    SortInputStats input;
+    input.size = bids.size();
+    if (bids.size() < 2) {
+        input.ascending = 1.0;
+        return input;
+    }
+
+    size_t samples = min(AUTO_SORT_SAMPLES, bids.size() - 1);
+    size_t inOrder = 0, reversed = 0;
+    unordered_set<string> distinct;
+    for (size_t k = 0; k < samples; ++k) {
+        size_t i = (bids.size() - 1) * k / samples;
+        inOrder += !(bids[i + 1].title < bids[i].title);
+        reversed += !(bids[i].title < bids[i + 1].title);
+        distinct.insert(bids[i].title);
+    }
+    input.ascending = double(inOrder) / samples;
+    input.descending = double(reversed) / samples;
+    input.duplicates = 1.0 - double(distinct.size()) / samples;
+    return input;
+}
+
+/**
+ * Pick the sort for a title ordering from the sampled statistics
+ */
+AutoSortChoice chooseSort(const SortInputStats& input, const SortCalibration& calibration) {
+    if (input.size <= calibration.insertionMax) {
+        return AUTO_INSERTION;
+    }
+    if (max(input.ascending, input.descending) >= calibration.presortedMin) {
+        return AUTO_RUN_MERGE;
+    }
+    if (input.duplicates >= calibration.duplicateMin) {
+        return AUTO_THREE_WAY;
+    }
+    if (input.size >= calibration.parallelMin) {
+        return AUTO_PARALLEL;
+    }
+    return AUTO_BLOCK_QUICK;
+}
+
+/**
+ * Run the chosen algorithm on the bids, ordered by title
+ */
+template <typename Stats>
+void runAutoSortChoice(vector<Bid>& bids, AutoSortChoice choice, Stats& stats) {
+    switch (choice) {
+    case AUTO_INSERTION:
+        if (!bids.empty()) {
+            binaryInsertionSort(bids, 0, bids.size(), 1, stats);
+        }
+        break;
+    case AUTO_RUN_MERGE:
+        naturalMergeSort(bids, stats);
+        break;
+    case AUTO_THREE_WAY:
+        quickSort3Way(bids, 0, bids.size() - 1, stats);
+        break;
+    case AUTO_PARALLEL:
+        parallelSort(bids, stats);
+        break;
+    default:
+        blockQuickSort(bids, stats);
+        break;
+    }
+}
+
+/**
+ * Best of three wall-clock times to sort every slice of the input
+ * separately, in milliseconds
+ */
+double timeSortChoice(const vector<Bid>& input, AutoSortChoice choice, size_t slice = SIZE_MAX) {
+    slice = min(slice, input.size());
+    double best = 1e300;
+    for (int rep = 0; rep < 3; ++rep) {
+        vector<vector<Bid>> slices;
+        for (size_t first = 0; first < input.size(); first += slice) {
+            slices.emplace_back(input.begin() + first, input.begin() + min(first + slice, input.size()));
+        }
+        auto start = chrono::steady_clock::now();
+        NoSortStats stats;
+        for (vector<Bid>& bids : slices) {
+            runAutoSortChoice(bids, choice, stats);
+        }
+        auto stop = chrono::steady_clock::now();
+        best = min(best, chrono::duration<double, milli>(stop - start).count());
+    }
+    return best;
+}
+
+/**
+ * Measure where each specialised sort starts beating block quick sort
+ * on this host
+ */
+SortCalibration calibrateSorts() {
+    SortCalibration calibration;
+    cout << "Calibrating sort selection..." << endl;
+
+    // insertion sort: largest size that still wins, timed over many slices
+    calibration.insertionMax = 0;
+    for (size_t size : { 8, 16, 24, 32, 48, 64, 96, 128 }) {
+        vector<Bid> batch = makeBenchmarkBids(size * 512, "random", size);
+        if (timeSortChoice(batch, AUTO_INSERTION, size) > timeSortChoice(batch, AUTO_BLOCK_QUICK, size)) {
+            break;
+        }
+        calibration.insertionMax = size;
+    }
+
+    const size_t size = 50000;
+    mt19937 rng(size);
+
+    // run merging: least sorted input it still wins on
+    vector<Bid> sorted = makeBenchmarkBids(size, "sorted", size);
+    calibration.presortedMin = 1.01; // never, unless a level below wins
+    for (double disorder : { 0.0, 0.001, 0.005, 0.01, 0.02, 0.05, 0.1, 0.2 }) {
+        vector<Bid> input = sorted;
+        for (size_t swaps = disorder * size; swaps > 0; --swaps) {
+            swap(input[rng() % size], input[rng() % size]);
+        }
+        if (timeSortChoice(input, AUTO_RUN_MERGE) > timeSortChoice(input, AUTO_BLOCK_QUICK)) {
+            break;
+        }
+        calibration.presortedMin = sampleSortInput(input).ascending;
+    }
+
+    // three-way partitioning: lowest duplicate ratio it still wins on
+    calibration.duplicateMin = 1.01;
+    for (size_t distinct : { 10, 100, 300, 1000, 3000 }) {
+        vector<Bid> input = makeBenchmarkBids(size, "random", size);
+        for (Bid& bid : input) {
+            bid.title = "Item " + to_string(rng() % distinct);
+        }
+        if (timeSortChoice(input, AUTO_THREE_WAY) > timeSortChoice(input, AUTO_BLOCK_QUICK)) {
+            break;
+        }
+        calibration.duplicateMin = sampleSortInput(input).duplicates;
+    }
+
+    // parallel sort: smallest size it wins at, if the host has the cores
+    calibration.parallelMin = SIZE_MAX;
+    if (thread::hardware_concurrency() > 1) {
+        for (size_t parallelSize : { 1 << 15, 1 << 17, 1 << 19, 1 << 21 }) {
+            vector<Bid> input = makeBenchmarkBids(parallelSize, "random", parallelSize);
+            if (timeSortChoice(input, AUTO_PARALLEL) < timeSortChoice(input, AUTO_BLOCK_QUICK)) {
+                calibration.parallelMin = parallelSize;
+                break;
+            }
+        }
+    }
+    return calibration;
+}
+
+/**
+ * Write the calibration as name=value lines
+ */
+void saveSortCalibration(const SortCalibration& calibration, const string& path) {
+    ofstream out(path);
+    out << "insertionMax=" << calibration.insertionMax << "\n";
+    out << "presortedMin=" << calibration.presortedMin << "\n";
+    out << "duplicateMin=" << calibration.duplicateMin << "\n";
+    out << "parallelMin=" << calibration.parallelMin << "\n";
+}
+
+/**
+ * Read a calibration file written by saveSortCalibration
+ *
+ * @return false if the file does not exist
+ */
+bool loadSortCalibration(SortCalibration& calibration, const string& path) {
+    ifstream in(path);
+    if (!in) {
+        return false;
+    }
+    string line;
+    while (getline(in, line)) {
+        size_t equals = line.find('=');
+        if (equals == string::npos) {
+            continue;
+        }
+        string name = line.substr(0, equals);
+        istringstream value(line.substr(equals + 1));
+        if (name == "insertionMax") {
+            value >> calibration.insertionMax;
+        } else if (name == "presortedMin") {
+            value >> calibration.presortedMin;
+        } else if (name == "duplicateMin") {
+            value >> calibration.duplicateMin;
+        } else if (name == "parallelMin") {
+            value >> calibration.parallelMin;
+        }
+    }
+    return true;
+}
+
+/**
+ * The host's calibration: loaded from SORT_CALIBRATION_FILE, or measured
+ * and saved there on first use
+ */
+const SortCalibration& sortCalibration() {
+    static SortCalibration calibration;
+    static bool loaded = false;
+    if (!loaded) {
+        if (!loadSortCalibration(calibration, SORT_CALIBRATION_FILE)) {
+            calibration = calibrateSorts();
+            saveSortCalibration(calibration, SORT_CALIBRATION_FILE);
+        }
+        loaded = true;
+    }
+    return calibration;
+}
+
+/**
+ * Sort bids by title with the algorithm the sampled input statistics
+ * and the host calibration favour
+ *
+ * @return the algorithm that was used
+ */
+template <typename Stats>
+AutoSortChoice autoSort(vector<Bid>& bids, Stats& stats) {
+    AutoSortChoice choice = chooseSort(sampleSortInput(bids), sortCalibration());
+    runAutoSortChoice(bids, choice, stats);
+    return choice;
+}
+
+/**
+ * Sort bids by a numeric column; fixed-width keys always go to radix sort
+ */
+template <typename Stats>
+AutoSortChoice autoSort(vector<Bid>& bids, NumericColumn column, Stats& stats) {
+    radixSort(bids, column, stats);
+    return AUTO_RADIX;
+}
+
+AutoSortChoice autoSort(vector<Bid>& bids) {
+    NoSortStats stats;
+    return autoSort(bids, stats);
+}
+
+//============================================================================
+// Sorting benchmark suite
+//============================================================================
+
+/**
+ * A sort algorithm that can be run by the benchmark, once uncounted
+ * for timing and once with operation counters
+ */
+struct SortMode {
+    string name;
+    function<void(vector<Bid>&)> sort;
+    function<void(vector<Bid>&, SortStats&)> countedSort;
+    size_t maxSize; // larger inputs are skipped
+};
+
+/**
+ * Build a sort mode from a generic lambda taking (bids, stats), which
+ * is instantiated with both counter policies
+ */
+template <typename SortFn>
+SortMode makeSortMode(const string& name, SortFn sortFn, size_t maxSize) {
+    return { name,
+        [sortFn](vector<Bid>& bids) {
+            NoSortStats stats;
+            sortFn(bids, stats);
+        },
+        [sortFn](vector<Bid>& bids, SortStats& stats) { sortFn(bids, stats); },
+        maxSize };
+}
+
+/**
+ * Every sort mode the benchmark compares; new sort modes register here
+ */
+vector<SortMode> benchmarkSortModes() {
+    return {
+        makeSortMode("selectionSort", [](vector<Bid>& bids, auto& stats) {
+            selectionSort(bids, stats);
+        }, BENCH_QUADRATIC_MAX_SIZE),
+        makeSortMode("quickSort", [](vector<Bid>& bids, auto& stats) {
+            quickSort(bids, 0, bids.size() - 1, stats);
+        }, BENCH_MAX_SIZE),
+        makeSortMode("std::sort", [](vector<Bid>& bids, auto& stats) {
+            sort(bids.begin(), bids.end(), [&stats](const Bid& a, const Bid& b) {
+                return titleLess(a.title, b.title, stats);
+            });
+        }, BENCH_MAX_SIZE),
+        makeSortMode("quickSort3Way", [](vector<Bid>& bids, auto& stats) {
+            quickSort3Way(bids, 0, bids.size() - 1, stats);
+        }, BENCH_MAX_SIZE),
+        makeSortMode("naturalMergeSort", [](vector<Bid>& bids, auto& stats) {
+            naturalMergeSort(bids, stats);
+        }, BENCH_MAX_SIZE),
+        makeSortMode("blockQuickSort", [](vector<Bid>& bids, auto& stats) {
+            blockQuickSort(bids, stats);
+        }, BENCH_MAX_SIZE),
+        makeSortMode("blockQuickSort(collated)", [](vector<Bid>& bids, auto& stats) {
+            collatedSort(bids, [](vector<Bid>& bids, auto& stats) {
+                blockQuickSort(bids, stats);
+            }, stats);
+        }, BENCH_MAX_SIZE),
+        makeSortMode("parallelSort", [](vector<Bid>& bids, auto& stats) {
+            parallelSort(bids, stats);
+        }, BENCH_MAX_SIZE),
+        makeSortMode("autoSort", [](vector<Bid>& bids, auto& stats) {
+            autoSort(bids, stats);
+        }, BENCH_MAX_SIZE),
+        // numeric orderings, compared against a comparison sort on the same key
+        makeSortMode("radixSort(amount)", [](vector<Bid>& bids, auto& stats) {
+            radixSort(bids, BY_AMOUNT, stats);
+        }, BENCH_MAX_SIZE),
+        makeSortMode("std::sort(amount)", [](vector<Bid>& bids, auto& stats) {
+            sort(bids.begin(), bids.end(), [&stats](const Bid& a, const Bid& b) {
+                stats.Compare();
+                return a.amount < b.amount;
+            });
+        }, BENCH_MAX_SIZE),
+    };
+}
+
+/**
+ * Build a synthetic bid vector in one of the benchmark input orders
+ *
+ * @param size number of bids
+ * @param order one of "random", "sorted", "reversed" or "duplicates"
+ * @param seed random seed so every algorithm sees the same input
+ */
+vector<Bid> makeBenchmarkBids(size_t size, const string& order, unsigned int seed) {
+    static const char* const commonTitles[] = {
+        "Chair", "Desk", "Dell Computer", "Dell Laptop", "File Cabinet",
+        "Table", "Bookcase", "Monitor", "Printer", "Couch",
+    };
+
+    mt19937 rng(seed);
+    uniform_int_distribution<unsigned int> word(0, 999999);
+    uniform_int_distribution<int> cents(100, 500000);
+
+    vector<Bid> bids(size);
+    for (size_t i = 0; i < size; ++i) {
+        bids[i].bidId = to_string(10000 + i);
+        if (order == "duplicates") {
+            bids[i].title = commonTitles[rng() % 10];
+        } else {
+            bids[i].title = "Item " + to_string(word(rng));
+        }
+        bids[i].fund = (i % 2 == 0) ? "General Fund" : "Enterprise";
+        bids[i].amount = cents(rng) / 100.0;
+    }
+
+    if (order == "sorted" || order == "reversed") {
+        sort(bids.begin(), bids.end(),
+                [](const Bid& a, const Bid& b) { return a.title < b.title; });
+        if (order == "reversed") {
+            reverse(bids.begin(), bids.end());
+        }
+    }
+    return bids;
+}
+
+/**
+ * Nearest-rank percentile of an ascending list of samples
+ */
+double percentile(const vector<double>& sorted, double pct) {
+    size_t rank = static_cast<size_t>(pct / 100.0 * (sorted.size() - 1) + 0.5);
+    return sorted[min(rank, sorted.size() - 1)];
+}
+
+/**
+ * Counts mispredicted branches of this process through the Linux perf
+ * interface; Available() is false where hardware counters are missing
+ */
+class BranchMissCounter {
+
+private:
+    int fd = -1;
+
+public:
+    BranchMissCounter() {
+#ifdef __linux__
+        perf_event_attr attr = {};
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+    }
+
+    ~BranchMissCounter() {
+#ifdef __linux__
+        if (fd >= 0) {
+            close(fd);
+        }
+#endif
+    }
+
+    bool Available() const {
+        return fd >= 0;
+    }
+
+    void Start() {
+#ifdef __linux__
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    // mispredictions since Start(), or -1 when unavailable
+    long long Stop() {
+        long long count = -1;
+#ifdef __linux__
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(fd, &count, sizeof(count)) != sizeof(count)) {
+                count = -1;
+            }
+        }
+#endif
+        return count;
+    }
+};
+
+/**
+ * Timing summary for one algorithm, input order and size
+ */
+struct BenchmarkResult {
+    string algorithm;
+    string order;
+    size_t size;
+    int repeats;
+    double medianMs;
+    double p10Ms;
+    double p90Ms;
+    double minMs;
+    double maxMs;
+    double bidsPerSec;          // throughput at the median time
+    long long branchMisses;     // median per run, -1 when unavailable
+    SortStats stats;            // operation counts from one counted run
+};
+
+/**
+ * Write benchmark results as CSV, or as JSON when the path ends in .json
+ */
+void writeBenchmarkResults(const vector<BenchmarkResult>& results, const string& path) {
+    ofstream out(path);
+    bool json = path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0;
+
+    if (json) {
+        out << "[\n";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const BenchmarkResult& r = results[i];
+            out << "  {\"algorithm\": \"" << r.algorithm << "\", \"order\": \"" << r.order
+                    << "\", \"size\": " << r.size << ", \"repeats\": " << r.repeats
+                    << ", \"median_ms\": " << r.medianMs << ", \"p10_ms\": " << r.p10Ms
+                    << ", \"p90_ms\": " << r.p90Ms << ", \"min_ms\": " << r.minMs
+                    << ", \"max_ms\": " << r.maxMs << ", \"bids_per_sec\": " << r.bidsPerSec
+                    << ", \"branch_misses\": " << r.branchMisses
+                    << ", \"comparisons\": " << r.stats.comparisons
+                    << ", \"swaps\": " << r.stats.swaps << ", \"moves\": " << r.stats.moves
+                    << ", \"max_depth\": " << r.stats.maxDepth
+                    << ", \"mean_imbalance\": " << r.stats.MeanImbalance()
+                    << ", \"max_imbalance\": " << r.stats.maxImbalance << "}"
+                    << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        out << "]\n";
+    } else {
+        out << "algorithm,order,size,repeats,median_ms,p10_ms,p90_ms,min_ms,max_ms,"
+                "bids_per_sec,branch_misses,comparisons,swaps,moves,max_depth,"
+                "mean_imbalance,max_imbalance\n";
+        for (const BenchmarkResult& r : results) {
+            out << r.algorithm << "," << r.order << "," << r.size << "," << r.repeats << ","
+                    << r.medianMs << "," << r.p10Ms << "," << r.p90Ms << ","
+                    << r.minMs << "," << r.maxMs << "," << r.bidsPerSec << ","
+                    << r.branchMisses << "," << r.stats.comparisons << ","
+                    << r.stats.swaps << "," << r.stats.moves << "," << r.stats.maxDepth << ","
+                    << r.stats.MeanImbalance() << "," << r.stats.maxImbalance << "\n";
+        }
+    }
+}
+
+/**
+ * Time every sort mode over every input order at sizes growing by 10x
+ * from BENCH_MIN_SIZE to maxSize, repeating each measurement
+ *
+ * @param outputPath where to write the CSV or JSON results
+ * @param maxSize the largest input size to run
+ * @param repeats measurements taken per configuration
+ */
+void runBenchmarks(const string& outputPath, size_t maxSize, int repeats) {
+    const string orders[] = { "random", "sorted", "reversed", "duplicates" };
+    vector<SortMode> modes = benchmarkSortModes();
+    vector<BenchmarkResult> results;
+    BranchMissCounter branchMisses;
+    if (!branchMisses.Available()) {
+        cout << "Branch miss counters unavailable; reporting -1" << endl;
+    }
+
+    // load or measure the auto sort calibration now, not inside a timing
+    sortCalibration();
+
+    for (size_t size = BENCH_MIN_SIZE; size <= maxSize; size *= 10) {
+        for (const string& order : orders) {
+            vector<Bid> input = makeBenchmarkBids(size, order, size);
+
+            for (const SortMode& mode : modes) {
+                if (size > mode.maxSize) {
+                    continue;
+                }
+
+                vector<double> samples;
+                vector<long long> misses;
+                for (int rep = 0; rep < repeats; ++rep) {
+                    vector<Bid> bids = input;
+                    auto start = chrono::steady_clock::now();
+                    branchMisses.Start();
+                    mode.sort(bids);
+                    misses.push_back(branchMisses.Stop());
+                    auto stop = chrono::steady_clock::now();
+                    samples.push_back(chrono::duration<double, milli>(stop - start).count());
+                }
+                sort(samples.begin(), samples.end());
+                sort(misses.begin(), misses.end());
+
+                // one extra run outside the timed ones collects the counts
+                SortStats stats;
+                vector<Bid> counted = input;
+                mode.countedSort(counted, stats);
+
+                double median = percentile(samples, 50);
+                BenchmarkResult result = { mode.name, order, size, repeats,
+                        median, percentile(samples, 10),
+                        percentile(samples, 90), samples.front(), samples.back(),
+                        median > 0 ? size / (median / 1000.0) : 0.0,
+                        misses[misses.size() / 2], stats };
+                results.push_back(result);
+                cout << mode.name << " | " << order << " | " << size
+                        << " | median " << result.medianMs << " ms"
+                        << " | branch misses " << result.branchMisses
+                        << " | comparisons " << stats.comparisons << endl;
+            }
+        }
+    }
+
+    writeBenchmarkResults(results, outputPath);
+    cout << results.size() << " results written to " << outputPath << endl;
+}
+
+
+/**
+ * Run one of the menu's sorts and report the elapsed time, plus the
+ * operation counts when counting is switched on
+ *
+ * @param bids the bids to sort
+ * @param name how the sort is named in the report
+ * @param countOperations run the counted instantiation of the sort
+ * @param sortFn generic lambda taking (bids, stats)
+ * @param collate order titles by their collation keys
+ */
+template <typename SortFn>
+void timeSort(vector<Bid>& bids, const string& name, bool countOperations, SortFn sortFn,
+        bool collate = false) {
+    SortStats stats;
+    NoSortStats noStats;
+
+    clock_t ticks = clock();
+    if (countOperations && collate) {
+        collatedSort(bids, sortFn, stats);
+    } else if (collate) {
+        collatedSort(bids, sortFn, noStats);
+    } else if (countOperations) {
+        sortFn(bids, stats);
+    } else {
+        sortFn(bids, noStats);
+    }
+    ticks = clock() - ticks;
+
+    cout << name << " completed in " << ticks << " clock ticks." << endl;
+    cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+    if (countOperations) {
+        displaySortStats(stats);
+    }
+}
+
+ 
+double strToDouble(string str, char ch) {
+    str.erase(remove(str.begin(), str.end(), ch), str.end());
+    return atof(str.c_str());
+}
+
+/**
+ * The one and only main() method
+ *
+ * @param arg[1] path to CSV file to load from (optional),
+ *        or --bench to run the sorting benchmark instead of the menu
+ * @param arg[2] with --bench, the CSV or JSON results file (optional)
+ * @param arg[3] with --bench, the largest input size (optional)
+ */
+int main(int argc, char* argv[]) {
+
+    if (argc >= 2 && string(argv[1]) == "--bench") {
+        string outputPath = argc >= 3 ? argv[2] : "sort_benchmark.csv";
+        size_t maxSize = BENCH_MAX_SIZE;
+        if (argc >= 4) {
+            char* last = nullptr;
+            errno = 0;
+            unsigned long long parsed = strtoull(argv[3], &last, 10);
+            if (!isdigit((unsigned char)argv[3][0]) || *last != '\0' || errno == ERANGE
+                    || parsed < BENCH_MIN_SIZE) {
+                cerr << "Usage: " << argv[0] << " --bench [results.csv|results.json] [max size >= "
+                     << BENCH_MIN_SIZE << "]" << endl;
+                return 1;
+            }
+            maxSize = parsed;
+        }
+        runBenchmarks(outputPath, maxSize, BENCH_REPEATS);
+        return 0;
+    }
+
+    // process command line arguments
+    string csvPath;
+    switch (argc) {
+    case 2:
+        csvPath = argv[1];
+        break;
+    default:
+        csvPath = "eBid_Monthly_Sales.csv";
+    }
+
+    // Define a vector to hold all the bids
+    vector<Bid> bids;
+
+    // Define a timer variable
+    clock_t ticks;
+
+    // operation counters are opt-in; the uncounted sorts pay nothing
+    bool countOperations = false;
+    // compare titles by their collation keys (option 14)
+    bool collateTitles = false;
+
+    // title order kept current as bids are added (options 15 and 16)
+    SortedBidIndex sortedIndex(bids);
+
+    int choice = 0;
+    while (choice != 9) {
+        cout << "Menu:" << endl;
+        cout << "  1. Load Bids" << endl;
+        cout << "  2. Display All Bids" << endl;
+        cout << "  3. Selection Sort All Bids" << endl;
+        cout << "  4. Quick Sort All Bids" << endl;
+        cout << "  5. Top K Bids by Amount" << endl;
+        cout << "  6. External Sort Bid File" << endl;
+        cout << "  7. Three-Way Quick Sort All Bids" << endl;
+        cout << "  8. Natural Merge Sort All Bids" << endl;
+        cout << "  10. Block Quick Sort All Bids" << endl;
+        cout << "  11. Radix Sort All Bids by Number" << endl;
+        cout << "  12. Turn Operation Counters " << (countOperations ? "Off" : "On") << endl;
+        cout << "  13. Auto Sort All Bids" << endl;
+        cout << "  14. Turn Title Collation " << (collateTitles ? "Off" : "On") << endl;
+        cout << "  15. Enter a Bid" << endl;
+        cout << "  16. Load More Bids" << endl;
+        cout << "  9. Exit" << endl;
+        cout << "Enter choice: ";
+        cin >> choice;
+
+        switch (choice) {
+
+        case 1:
+            // Initialize a timer variable before loading bids
+            ticks = clock();
+
+            // Complete the method call to load the bids
+            bids = loadBids(csvPath);
+            sortedIndex.MarkDirty();
+
+            cout << bids.size() << " bids read" << endl;
+
+            // Calculate elapsed time and display result
+            ticks = clock() - ticks; // current clock ticks minus starting clock ticks
+            cout << "time: " << ticks << " clock ticks" << endl;
+            cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+
+            break;
+
+        case 2:
+            // Loop and display the bids read, by title if the order is known
+            for (int i = 0; i < bids.size(); ++i) {
+                displayBid(sortedIndex.Dirty() ? bids[i] : sortedIndex.At(i));
+            }
+            cout << endl;
+            break;
+        case 3:
+            timeSort(bids, "Selection sort", countOperations, [](vector<Bid>& bids, auto& stats) {
+                selectionSort(bids, stats);
+            }, collateTitles);
+            sortedIndex.MarkSorted(!collateTitles);
+            break;  
+        case 4:
+            timeSort(bids, "Quick sort", countOperations, [](vector<Bid>& bids, auto& stats) {
+                quickSort(bids, 0, bids.size() - 1, stats);
+            }, collateTitles);
+            sortedIndex.MarkSorted(!collateTitles);
+            break;  
+        case 5: {
+            size_t k = 0;
+            string fund;
+            cout << "Enter K: ";
+            cin >> k;
+            cout << "Enter fund (blank for all): ";
+            cin.ignore();
+            getline(cin, fund);
+
+            ticks = clock();
+            vector<Bid> top = topKBids(bids, k, fund);
+            ticks = clock() - ticks;
+
+            for (const Bid& bid : top) {
+                displayBid(bid);
+            }
+            cout << "Top " << top.size() << " bids found in " << ticks << " clock ticks." << endl;
+            cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+            break;
+        }
+        case 6: {
+            ExternalSortConfig config;
+            size_t budgetMb = EXTERNAL_SORT_BUDGET_MB;
+            string outputPath;
+            cout << "Enter memory budget in MB: ";
+            cin >> budgetMb;
+            config.memoryBudget = budgetMb * 1024 * 1024;
+            cout << "Enter temp directory (blank for " << EXTERNAL_SORT_TEMP_DIR << "): ";
+            cin.ignore();
+            getline(cin, config.tempDir);
+            if (config.tempDir.empty()) {
+                config.tempDir = EXTERNAL_SORT_TEMP_DIR;
+            }
+            cout << "Enter output file: ";
+            getline(cin, outputPath);
+
+            ticks = clock();
+            try {
+                size_t written = externalSortBids(csvPath, outputPath, config);
+                cout << written << " bids written to " << outputPath << endl;
+            } catch (csv::Error &e) {
+                std::cerr << e.what() << std::endl;
+            }
+            ticks = clock() - ticks;
+            cout << "External sort completed in " << ticks << " clock ticks." << endl;
+            cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+            break;
+        }
+        case 7:
+            timeSort(bids, "Three-way quick sort", countOperations, [](vector<Bid>& bids, auto& stats) {
+                quickSort3Way(bids, 0, bids.size() - 1, stats);
+            }, collateTitles);
+            sortedIndex.MarkSorted(!collateTitles);
+            break;
+        case 8:
+            timeSort(bids, "Natural merge sort", countOperations, [](vector<Bid>& bids, auto& stats) {
+                naturalMergeSort(bids, stats);
+            }, collateTitles);
+            sortedIndex.MarkSorted(!collateTitles);
+            break;
+        case 10:
+            timeSort(bids, "Block quick sort", countOperations, [](vector<Bid>& bids, auto& stats) {
+                blockQuickSort(bids, stats);
+            }, collateTitles);
+            sortedIndex.MarkSorted(!collateTitles);
+            break;
+        case 11: {
+            int column = 1;
+            cout << "Sort by 1. Amount or 2. Auction ID: ";
+            cin >> column;
+            NumericColumn key = column == 2 ? BY_AUCTION_ID : BY_AMOUNT;
+
+            timeSort(bids, "Radix sort", countOperations, [key](vector<Bid>& bids, auto& stats) {
+                radixSort(bids, key, stats);
+            });
+            sortedIndex.MarkDirty();
+            break;
+        }
+        case 13: {
+            int column = 1;
+            cout << "Sort by 1. Title, 2. Amount or 3. Auction ID: ";
+            cin >> column;
+
+            bool byTitle = column != 2 && column != 3;
+
+            // title order already maintained: lay the bids out, skip the sort
+            if (byTitle && !collateTitles && !sortedIndex.Dirty()) {
+                sortedIndex.Gather();
+                cout << "Bids already in title order; re-sort skipped" << endl;
+                break;
+            }
+
+            AutoSortChoice choice = AUTO_BLOCK_QUICK;
+            timeSort(bids, "Auto sort", countOperations, [column, &choice](vector<Bid>& bids, auto& stats) {
+                if (column == 2 || column == 3) {
+                    choice = autoSort(bids, column == 3 ? BY_AUCTION_ID : BY_AMOUNT, stats);
+                } else {
+                    choice = autoSort(bids, stats);
+                }
+            }, collateTitles && byTitle);
+            cout << "Auto sort chose " << autoSortName(choice) << endl;
+            sortedIndex.MarkSorted(byTitle && !collateTitles);
+            break;
+        }
+        case 12:
+            countOperations = !countOperations;
+            cout << "Operation counters " << (countOperations ? "on" : "off") << endl;
+            break;
+        case 14:
+            collateTitles = !collateTitles;
+            cout << "Title collation " << (collateTitles ? "on" : "off") << endl;
+            break;
+        case 15:
+            sortedIndex.Insert(getBid());
+            cout << bids.size() << " bids" << (sortedIndex.Dirty() ? "" : ", kept in title order") << endl;
+            break;
+        case 16: {
+            string morePath;
+            cout << "Enter CSV path: ";
+            cin.ignore();
+            getline(cin, morePath);
+
+            ticks = clock();
+            vector<Bid> batch;
+            try {
+                batch = loadBids(morePath);
+            } catch (csv::Error &e) {
+                std::cerr << e.what() << std::endl;
+                break;
+            }
+            size_t count = batch.size();
+            sortedIndex.InsertBatch(move(batch));
+            ticks = clock() - ticks;
+
+            cout << count << " bids added" << (sortedIndex.Dirty() ? "" : " in title order") << endl;
+            cout << "time: " << ticks << " clock ticks" << endl;
+            cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+            break;
+        }
          default:
          cout << "Invalid choice. Please try again." << endl;
          break;
@@ -7,8 +7,19 @@
 //============================================================================
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <iostream>
+#include <new>
+#include <random>
+#include <sstream>
+#include <thread>
 #include <time.h>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "CSVparser.hpp"
 
@@ -18,6 +29,21 @@ using namespace std;
 // Global definitions visible to all methods and classes
 //============================================================================
 
+// bytes carved into list nodes per pool slab
+const size_t NODE_POOL_SLAB_BYTES = 64 * 1024;
+
+// skip list towers are at most this tall, plenty for 16M bids at p = 1/4
+const int SKIP_LIST_MAX_HEIGHT = 12;
+
+// bytes per skip list arena block
+const size_t SKIP_LIST_ARENA_BYTES = 256 * 1024;
+
+// threads that can be inside ConcurrentLinkedList operations at once
+const int CONCURRENT_LIST_MAX_THREADS = 64;
+
+// removals between attempts to advance the reclamation epoch
+const int CONCURRENT_LIST_RETIRE_BATCH = 64;
+
 // forward declarations
 double strToDouble(string str, char ch);
 
@@ -32,10 +58,129 @@ struct Bid {
     }
 };
 
+//============================================================================
+// Pooled node allocator
+//============================================================================
+
+/**
+ * Hands out nodes carved from large slabs instead of one heap block per
+ * node. Freed nodes go on an intrusive free list and are reused first;
+ * the slabs are returned only when the pool is destroyed, one free per
+ * slab.
+ */
+template <typename T>
+class NodePool {
+
+private:
+    // a free slot reuses the node's own storage as the free-list link
+    union Slot {
+        Slot* nextFree;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    static const size_t SLAB_NODES = NODE_POOL_SLAB_BYTES / sizeof(Slot) > 0 ? NODE_POOL_SLAB_BYTES / sizeof(Slot) : 1;
+
+    vector<Slot*> slabs;
+    Slot* freeList = nullptr;
+    size_t slabUsed = SLAB_NODES; // slots handed out from the newest slab
+
+public:
+    NodePool() {}
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    /**
+     * Destructor; nodes still in use must have been Delete()d already
+     */
+    ~NodePool() {
+        for (Slot* slab : slabs) {
+            delete[] slab;
+        }
+    }
+
+    /**
+     * Construct a node in a recycled slot, or the next slot of the newest
+     * slab
+     */
+    template <typename... Args>
+    T* New(Args&&... args) {
+        Slot* slot;
+        if (freeList != nullptr) {
+            slot = freeList;
+            freeList = freeList->nextFree;
+        } else {
+            if (slabUsed == SLAB_NODES) {
+                slabs.push_back(new Slot[SLAB_NODES]);
+                slabUsed = 0;
+            }
+            slot = &slabs.back()[slabUsed++];
+        }
+        return new (slot->storage) T(forward<Args>(args)...);
+    }
+
+    /**
+     * Take over another pool's slabs, so nodes it handed out stay valid
+     * after it is destroyed. Its free slots are only reused if this pool
+     * has none of its own.
+     */
+    void Adopt(NodePool& other) {
+        if (&other == this || other.slabs.empty()) {
+            return;
+        }
+        // keep this pool's newest slab last so slabUsed still applies
+        slabs.insert(slabs.empty() ? slabs.end() : slabs.end() - 1, other.slabs.begin(), other.slabs.end());
+        if (slabs.size() == other.slabs.size()) {
+            slabUsed = other.slabUsed;
+        }
+        if (freeList == nullptr) {
+            freeList = other.freeList;
+        }
+        other.slabs.clear();
+        other.freeList = nullptr;
+        other.slabUsed = SLAB_NODES;
+    }
+
+    /**
+     * Destroy a node and put its slot on the free list
+     */
+    void Delete(T* node) {
+        node->~T();
+        Slot* slot = reinterpret_cast<Slot*>(node);
+        slot->nextFree = freeList;
+        freeList = slot;
+    }
+};
+
+/**
+ * Order of bid ids when sorting: shorter ids first, then by characters,
+ * which is numeric order for the all-digit ids in the files
+ */
+bool bidIdLess(const string& a, const string& b) {
+    return a.size() != b.size() ? a.size() < b.size() : a < b;
+}
+
 //============================================================================
 // Linked-List class definition
 //============================================================================
 
+/**
+ * Which bid field LinkedList::Sort orders by
+ */
+enum ListSortKey {
+    SORT_BY_TITLE,
+    SORT_BY_AMOUNT,
+    SORT_BY_BID_ID
+};
+
+/**
+ * How LinkedList::Search reorders the list after a hit
+ */
+enum SearchPolicy {
+    SEARCH_FIXED,         // leave the list alone
+    SEARCH_MOVE_TO_FRONT, // move the found node to the head
+    SEARCH_TRANSPOSE      // swap the found node with the one before it
+};
+
 /**
  * Define a class containing data members and methods to
  * implement a linked-list.
@@ -47,27 +192,571 @@ private:
     struct Node {
         Bid bid;
         Node *next;
+        Node *prev;
 
         // default constructor
         Node() {
             next = nullptr;
+            prev = nullptr;
         }
 
         // initialize with a bid
         Node(Bid aBid) {
             bid = aBid;
             next = nullptr;
+            prev = nullptr;
         }
     };
 
+    // first node holding a bid id, and how many nodes hold it
+    struct IndexEntry {
+        Node* first = nullptr;
+        int count = 0;
+    };
+
+    NodePool<Node> pool;
     Node* head;
     Node* tail;
     int size = 0;
 
+    // optional bidId index for O(1) expected Search and Remove
+    bool indexed = false;
+    unordered_map<string, IndexEntry> index;
+
+    // self-organizing search, and the depth of the scans it made
+    SearchPolicy searchPolicy = SEARCH_FIXED;
+    long long searches = 0;
+    long long searchDepth = 0;
+
+    void unlink(Node* node);
+    void promote(Node* node);
+    void indexChain(Node* first);
+
 public:
     LinkedList();
     virtual ~LinkedList();
     void Append(Bid bid);
+    void AppendAll(const vector<Bid>& bids);
+    void Splice(LinkedList&& other);
+    void Prepend(Bid bid);
+    void PrintList();
+    void Remove(string bidId);
+    int RemoveAll(const vector<string>& bidIds);
+    Bid Search(string bidId);
+    int Size();
+    void SetIndexed(bool enable);
+    bool Indexed();
+    void SetSearchPolicy(SearchPolicy policy);
+    SearchPolicy GetSearchPolicy();
+    double AverageSearchDepth();
+    void Sort(ListSortKey key);
+};
+
+/**
+ * Default constructor
+ */
+LinkedList::LinkedList() {
+   head = nullptr;
+   tail = nullptr;
+}
+
+/**
+ * Destructor
+ */
+LinkedList::~LinkedList() {
+    Node* current = head;
+    Node* temp;
+    while (current != nullptr) { // loop over each node, detach from list then delete
+        temp = current; // hang on to current node
+        current = current->next; // make current the next node
+        pool.Delete(temp); // delete the orphan node
+    }
+    
+ head = nullptr;  // list is now empty
+ tail = nullptr;
+
+}
+
+/**
+ * Append a new bid to the end of the list
+ */
+void LinkedList::Append(Bid bid) {
+    Node* newNode = pool.New(bid); // create new node
+
+    if (head == nullptr) { // empty list: new node is head and tail
+        head = newNode;
+        tail = newNode;
+    } else {
+        tail->next = newNode; // current tail points to the new node
+        newNode->prev = tail; // and back
+        tail = newNode; // new node becomes the tail
+    }
+    size++; // increase size count
+
+    if (indexed) { // a later duplicate leaves the first match in place
+        IndexEntry& entry = index[bid.bidId];
+        if (entry.count++ == 0) {
+            entry.first = newNode;
+        }
+    }
+}
+
+/**
+ * Append many bids: build their chain on the side in one pass, then join
+ * it to the tail with a single pointer update
+ *
+ * @param bids the bids to append, in order
+ */
+void LinkedList::AppendAll(const vector<Bid>& bids) {
+    if (bids.empty()) {
+        return;
+    }
+    Node* first = nullptr;
+    Node* last = nullptr;
+    for (const Bid& bid : bids) {
+        Node* node = pool.New(bid);
+        node->prev = last;
+        if (last == nullptr) {
+            first = node;
+        } else {
+            last->next = node;
+        }
+        last = node;
+    }
+
+    if (tail == nullptr) {
+        head = first;
+    } else {
+        tail->next = first;
+        first->prev = tail;
+    }
+    tail = last;
+    size += bids.size();
+
+    if (indexed) {
+        indexChain(first);
+    }
+}
+
+/**
+ * Move all of another list's bids onto the end of this one in O(1),
+ * taking over the pool slabs they live in; other is left empty. With the
+ * index on, the moved bids still have to be indexed, O(other's size).
+ *
+ * @param other the list to empty into this one
+ */
+void LinkedList::Splice(LinkedList&& other) {
+    if (&other == this || other.head == nullptr) {
+        return;
+    }
+    pool.Adopt(other.pool);
+
+    Node* first = other.head;
+    if (tail == nullptr) {
+        head = first;
+    } else {
+        tail->next = first;
+        first->prev = tail;
+    }
+    tail = other.tail;
+    size += other.size;
+
+    other.head = nullptr;
+    other.tail = nullptr;
+    other.size = 0;
+    other.index.clear();
+
+    if (indexed) {
+        indexChain(first);
+    }
+}
+
+/**
+ * Prepend a new bid to the start of the list
+ */
+void LinkedList::Prepend(Bid bid) {
+     Node* newNode = pool.New(bid);// Create new node
+
+    if (head != nullptr) {// if there is already something at the head...
+    
+        newNode->next = head; // new node points to current head as its next node
+        head->prev = newNode; // current head points back to the new node
+        head = newNode; // head now becomes the new node
+      }else {
+        head = newNode; // head is equal to new node
+        tail = newNode; // tail is equal to new node
+      }
+    size++; //increase size count
+
+    if (indexed) { // the new node is now the first match
+        IndexEntry& entry = index[bid.bidId];
+        entry.first = newNode;
+        entry.count++;
+    }
+}
+
+
+/**
+ * Simple output of all bids in the list
+ */
+void LinkedList::PrintList() {
+     Node* current = head;// start at the head
+    while (current != nullptr) {// while loop over each node looking for a match
+        cout << current->bid.bidId << ": " 
+        << current->bid.title << " | "
+        << current->bid.amount << " | " 
+        << current->bid.fund << endl;//output current bidID, title, amount and fund
+        current = current->next;//set current equal to next
+}
+}
+
+/**
+ * Remove a specified bid
+ *
+ * @param bidId The bid id to remove from the list
+ */
+
+
+void LinkedList::Remove(string bidId) {
+    if (indexed) {
+        auto found = index.find(bidId);
+        if (found == index.end()) {
+            return;
+        }
+        Node* node = found->second.first;
+        if (--found->second.count == 0) {
+            index.erase(found);
+        } else { // duplicate ids: the next match is further down the list
+            Node* next = node->next;
+            while (next->bid.bidId != bidId) {
+                next = next->next;
+            }
+            found->second.first = next;
+        }
+        unlink(node);
+        return;
+    }
+
+    // Special case: head matches
+    if (head != nullptr && head->bid.bidId == bidId) {
+        Node* temp = head;
+        head = head->next; // move head to next node
+        if (head == nullptr) {
+            tail = nullptr; // list is now empty
+        } else {
+            head->prev = nullptr;
+        }
+        pool.Delete(temp); // free memory
+        size--; // decrease size count
+        return;
+    }
+
+    // Traverse the list
+    Node* current = head;
+    while (current != nullptr && current->next != nullptr) {
+        if (current->next->bid.bidId == bidId) {
+            Node* temp = current->next; // hold onto the next node
+            current->next = temp->next; // bypass the node
+            if (temp == tail) {
+                tail = current; // update tail if last node removed
+            } else {
+                temp->next->prev = current;
+            }
+            pool.Delete(temp); // free memory
+            size--; // decrease size count
+            return;
+        }
+        current = current->next; // move to next node
+    }
+}
+
+
+
+/**
+ * Remove every bid whose id is listed, in a single pass over the list
+ *
+ * @param bidIds The bid ids to remove
+ * @return the number of bids removed
+ */
+int LinkedList::RemoveAll(const vector<string>& bidIds) {
+    unordered_set<string> doomed(bidIds.begin(), bidIds.end());
+    int removed = 0;
+    Node* current = head;
+    while (current != nullptr) {
+        Node* next = current->next; // unlink frees current
+        if (doomed.count(current->bid.bidId) > 0) {
+            if (indexed) {
+                index.erase(current->bid.bidId);
+            }
+            unlink(current);
+            removed++;
+        }
+        current = next;
+    }
+    return removed;
+}
+
+/**
+ * Search for the specified bidId
+ *
+ * @param bidId The bid id to search for
+ */
+Bid LinkedList::Search(string bidId) {
+    if (indexed) {
+        auto found = index.find(bidId);
+        return found == index.end() ? Bid() : found->second.first->bid;
+    }
+
+    // special case if matching bid is the head
+    Node*current = head;// start at the head of the list
+    searches++;
+    while(current != nullptr) { // keep searching until end reached with while loop (current != nullptr)
+        searchDepth++; // one more node compared
+        if(current->bid.bidId == bidId) {   // if current node bidID is equal to search bidID
+            Bid found = current->bid;
+            promote(current); // move hot bids toward the head
+            return found; // return the current bid
+        } else {
+            current = current->next; // else current node is equal to next node
+        }
+    }
+    //(the next two statements will only execute if search item is not found)
+       Bid emptyBid; //create new empty bid
+        return emptyBid;// return the empty bid 
+}
+
+/**
+ * Returns the current size (number of elements) in the list
+ */
+int LinkedList::Size() {
+    return size;
+}
+
+/**
+ * Take a node out of the list in O(1) using its back pointer
+ */
+void LinkedList::unlink(Node* node) {
+    if (node->prev == nullptr) {
+        head = node->next;
+    } else {
+        node->prev->next = node->next;
+    }
+    if (node->next == nullptr) {
+        tail = node->prev;
+    } else {
+        node->next->prev = node->prev;
+    }
+    pool.Delete(node);
+    size--;
+}
+
+/**
+ * Stable bottom-up merge sort by relinking the nodes: runs of width 1, 2,
+ * 4, ... are merged pairwise along the list until one pass does a single
+ * merge. O(n log n) compares and O(1) extra space; the back pointers and
+ * tail are rebuilt in a final pass.
+ *
+ * @param key the bid field to order by
+ */
+void LinkedList::Sort(ListSortKey key) {
+    if (head == nullptr) {
+        return;
+    }
+    auto less = [key](const Bid& a, const Bid& b) {
+        switch (key) {
+        case SORT_BY_AMOUNT:
+            return a.amount < b.amount;
+        case SORT_BY_BID_ID:
+            return bidIdLess(a.bidId, b.bidId);
+        default:
+            return a.title < b.title;
+        }
+    };
+
+    for (int width = 1;; width *= 2) {
+        Node* rest = head;
+        Node* last = nullptr;
+        int merges = 0;
+        head = nullptr;
+
+        while (rest != nullptr) {
+            merges++;
+
+            // the left run starts at rest, the right run just after it
+            Node* left = rest;
+            Node* right = rest;
+            int leftSize = 0;
+            while (leftSize < width && right != nullptr) {
+                right = right->next;
+                leftSize++;
+            }
+            int rightSize = width;
+
+            // merge, taking from the left run on ties to stay stable
+            while (leftSize > 0 || (rightSize > 0 && right != nullptr)) {
+                Node* next;
+                if (leftSize > 0 && (rightSize == 0 || right == nullptr || !less(right->bid, left->bid))) {
+                    next = left;
+                    left = left->next;
+                    leftSize--;
+                } else {
+                    next = right;
+                    right = right->next;
+                    rightSize--;
+                }
+                if (last == nullptr) {
+                    head = next;
+                } else {
+                    last->next = next;
+                }
+                last = next;
+            }
+            rest = right;
+        }
+        last->next = nullptr;
+
+        if (merges <= 1) {
+            break;
+        }
+    }
+
+    // restore the back pointers and tail
+    Node* previous = nullptr;
+    for (Node* current = head; current != nullptr; current = current->next) {
+        current->prev = previous;
+        previous = current;
+    }
+    tail = previous;
+
+    // the first node of a duplicated id may have changed
+    if (indexed) {
+        SetIndexed(true);
+    }
+}
+
+/**
+ * Move a node found by Search toward the head as the search policy says.
+ * The index, if on, still holds: the node was the first with its id and
+ * only overtakes nodes with other ids.
+ */
+void LinkedList::promote(Node* node) {
+    Node* previous = node->prev;
+    if (previous == nullptr || searchPolicy == SEARCH_FIXED) {
+        return;
+    }
+
+    // take the node out
+    previous->next = node->next;
+    if (node->next == nullptr) {
+        tail = previous;
+    } else {
+        node->next->prev = previous;
+    }
+
+    // and put it back at the head, or just before its old predecessor
+    Node* before = searchPolicy == SEARCH_MOVE_TO_FRONT ? nullptr : previous->prev;
+    Node* after = before == nullptr ? head : before->next;
+    node->prev = before;
+    node->next = after;
+    after->prev = node;
+    if (before == nullptr) {
+        head = node;
+    } else {
+        before->next = node;
+    }
+}
+
+/**
+ * Choose how Search reorders the list after a hit. Switching policies
+ * starts the average depth over.
+ */
+void LinkedList::SetSearchPolicy(SearchPolicy policy) {
+    searchPolicy = policy;
+    searches = 0;
+    searchDepth = 0;
+}
+
+/**
+ * The current search policy
+ */
+SearchPolicy LinkedList::GetSearchPolicy() {
+    return searchPolicy;
+}
+
+/**
+ * Average number of nodes a scanning Search compared, misses included;
+ * indexed searches are not counted
+ */
+double LinkedList::AverageSearchDepth() {
+    return searches == 0 ? 0.0 : double(searchDepth) / searches;
+}
+
+/**
+ * Turn the bidId index on or off. Turning it on indexes the bids already
+ * in the list in one pass; list order, and so PrintList, is unchanged.
+ *
+ * @param enable whether Search and Remove should use the index
+ */
+void LinkedList::SetIndexed(bool enable) {
+    index.clear();
+    indexed = enable;
+    if (!indexed) {
+        return;
+    }
+    index.reserve(size);
+    indexChain(head);
+}
+
+/**
+ * Add the nodes from first to the tail to the index, in list order
+ */
+void LinkedList::indexChain(Node* first) {
+    for (Node* current = first; current != nullptr; current = current->next) {
+        IndexEntry& entry = index[current->bid.bidId];
+        if (entry.count++ == 0) {
+            entry.first = current;
+        }
+    }
+}
+
+/**
+ * Whether Search and Remove currently use the bidId index
+ */
+bool LinkedList::Indexed() {
+    return indexed;
+}
+
+//============================================================================
+// Unrolled linked-list class definition
+//============================================================================
+
+// bids held by one unrolled node; 8 bids keep a node near 1KB
+const int UNROLLED_NODE_CAPACITY = 8;
+
+/**
+ * Same list interface as LinkedList, but each node holds a small array of
+ * bids, so scans walk contiguous memory and follow one pointer per
+ * UNROLLED_NODE_CAPACITY bids instead of one per bid.
+ */
+class UnrolledLinkedList {
+
+private:
+    struct Node {
+        Bid bids[UNROLLED_NODE_CAPACITY];
+        int count = 0;
+        Node* next = nullptr;
+    };
+
+    Node* head = nullptr;
+    Node* tail = nullptr;
+    int size = 0;
+
+    void unlink(Node* previous, Node* node);
+
+public:
+    UnrolledLinkedList() {}
+    virtual ~UnrolledLinkedList();
+    void Append(Bid bid);
     void Prepend(Bid bid);
     void PrintList();
     void Remove(string bidId);
@@ -75,132 +764,710 @@ public:
     int Size();
 };
 
+/**
+ * Destructor
+ */
+UnrolledLinkedList::~UnrolledLinkedList() {
+    while (head != nullptr) {
+        Node* temp = head;
+        head = head->next;
+        delete temp;
+    }
+    tail = nullptr;
+}
+
+/**
+ * Append a new bid to the end of the list, filling the tail node first
+ */
+void UnrolledLinkedList::Append(Bid bid) {
+    if (tail == nullptr || tail->count == UNROLLED_NODE_CAPACITY) {
+        Node* newNode = new Node();
+        if (tail == nullptr) {
+            head = newNode;
+        } else {
+            tail->next = newNode;
+        }
+        tail = newNode;
+    }
+    tail->bids[tail->count++] = bid;
+    size++;
+}
+
+/**
+ * Prepend a new bid to the start of the list, shifting it into the head
+ * node if there is room
+ */
+void UnrolledLinkedList::Prepend(Bid bid) {
+    if (head == nullptr || head->count == UNROLLED_NODE_CAPACITY) {
+        Node* newNode = new Node();
+        newNode->next = head;
+        head = newNode;
+        if (tail == nullptr) {
+            tail = newNode;
+        }
+    }
+    move_backward(head->bids, head->bids + head->count, head->bids + head->count + 1);
+    head->bids[0] = bid;
+    head->count++;
+    size++;
+}
+
+/**
+ * Simple output of all bids in the list
+ */
+void UnrolledLinkedList::PrintList() {
+    for (Node* current = head; current != nullptr; current = current->next) {
+        for (int i = 0; i < current->count; ++i) {
+            const Bid& bid = current->bids[i];
+            cout << bid.bidId << ": " << bid.title << " | " << bid.amount << " | " << bid.fund << endl;
+        }
+    }
+}
+
+/**
+ * Take an emptied node out of the chain
+ *
+ * @param previous the node before it, nullptr for the head
+ */
+void UnrolledLinkedList::unlink(Node* previous, Node* node) {
+    if (previous == nullptr) {
+        head = node->next;
+    } else {
+        previous->next = node->next;
+    }
+    if (node == tail) {
+        tail = previous;
+    }
+    delete node;
+}
+
+/**
+ * Remove the first bid with the given id. The bids after it in the same
+ * node close the gap; a node that runs half empty takes in its successor
+ * when that fits, so scans stay dense.
+ *
+ * @param bidId The bid id to remove from the list
+ */
+void UnrolledLinkedList::Remove(string bidId) {
+    Node* previous = nullptr;
+    for (Node* current = head; current != nullptr; previous = current, current = current->next) {
+        for (int i = 0; i < current->count; ++i) {
+            if (current->bids[i].bidId != bidId) {
+                continue;
+            }
+            move(current->bids + i + 1, current->bids + current->count, current->bids + i);
+            current->bids[--current->count] = Bid();
+            size--;
+
+            if (current->count == 0) {
+                unlink(previous, current);
+            } else if (current->next != nullptr && current->count < UNROLLED_NODE_CAPACITY / 2
+                    && current->count + current->next->count <= UNROLLED_NODE_CAPACITY) {
+                Node* next = current->next;
+                move(next->bids, next->bids + next->count, current->bids + current->count);
+                current->count += next->count;
+                unlink(current, next);
+            }
+            return;
+        }
+    }
+}
+
+/**
+ * Search for the specified bidId
+ *
+ * @param bidId The bid id to search for
+ * @return the first matching bid, or an empty bid if none matches
+ */
+Bid UnrolledLinkedList::Search(string bidId) {
+    for (Node* current = head; current != nullptr; current = current->next) {
+        for (int i = 0; i < current->count; ++i) {
+            if (current->bids[i].bidId == bidId) {
+                return current->bids[i];
+            }
+        }
+    }
+    Bid emptyBid;
+    return emptyBid;
+}
+
+/**
+ * Returns the current size (number of elements) in the list
+ */
+int UnrolledLinkedList::Size() {
+    return size;
+}
+
+//============================================================================
+// Skip list class definition
+//============================================================================
+
+/**
+ * Bids kept ordered by bidId with probabilistic O(log n) Search, Append
+ * (which inserts in order) and Remove, and range scans between two ids.
+ * Each node and its tower of forward pointers are bump-allocated together
+ * from arena blocks; removed nodes wait on a free list per tower height.
+ */
+class SkipList {
+
+private:
+    struct Node {
+        Bid bid;
+        int height;
+        Node** next; // height forward pointers, stored just after the node
+    };
+
+    vector<char*> blocks;
+    size_t blockUsed = SKIP_LIST_ARENA_BYTES;
+    Node* freeNodes[SKIP_LIST_MAX_HEIGHT + 1] = {};
+
+    Node* head;
+    int height = 1;
+    int size = 0;
+    mt19937 rng;
+
+    Node* newNode(const Bid& bid, int nodeHeight);
+    int randomHeight();
+    Node* findPredecessors(const string& bidId, Node** update);
+
+public:
+    SkipList();
+    virtual ~SkipList();
+    void Append(Bid bid);
+    void PrintList();
+    vector<Bid> Range(string fromId, string toId);
+    void Remove(string bidId);
+    Bid Search(string bidId);
+    int Size();
+};
+
+/**
+ * Default constructor
+ */
+SkipList::SkipList() : rng(5489) {
+    head = newNode(Bid(), SKIP_LIST_MAX_HEIGHT);
+}
+
+/**
+ * Destructor; the arena blocks are released whole
+ */
+SkipList::~SkipList() {
+    for (Node* current = head; current != nullptr;) {
+        Node* next = current->next[0];
+        current->~Node();
+        current = next;
+    }
+    for (Node* current : freeNodes) {
+        while (current != nullptr) {
+            Node* next = current->next[0];
+            current->~Node();
+            current = next;
+        }
+    }
+    for (char* block : blocks) {
+        delete[] block;
+    }
+}
+
+/**
+ * A node with room for nodeHeight forward pointers, from the free list
+ * for that height or else the arena
+ */
+SkipList::Node* SkipList::newNode(const Bid& bid, int nodeHeight) {
+    Node* node = freeNodes[nodeHeight];
+    if (node != nullptr) {
+        freeNodes[nodeHeight] = node->next[0];
+        node->bid = bid;
+    } else {
+        size_t bytes = sizeof(Node) + nodeHeight * sizeof(Node*);
+        if (blockUsed + bytes > SKIP_LIST_ARENA_BYTES) {
+            blocks.push_back(new char[SKIP_LIST_ARENA_BYTES]);
+            blockUsed = 0;
+        }
+        char* raw = blocks.back() + blockUsed;
+        blockUsed += (bytes + alignof(Node) - 1) / alignof(Node) * alignof(Node);
+
+        node = new (raw) Node();
+        node->bid = bid;
+        node->height = nodeHeight;
+        node->next = reinterpret_cast<Node**>(raw + sizeof(Node));
+    }
+    for (int level = 0; level < nodeHeight; ++level) {
+        node->next[level] = nullptr;
+    }
+    return node;
+}
+
+/**
+ * Tower height with P(height > h) = 4^-h
+ */
+int SkipList::randomHeight() {
+    int nodeHeight = 1;
+    while (nodeHeight < SKIP_LIST_MAX_HEIGHT && (rng() & 3) == 0) {
+        nodeHeight++;
+    }
+    return nodeHeight;
+}
+
+/**
+ * Walk down the towers to the last node before bidId on every level
+ *
+ * @param update receives the predecessor on each level, may be nullptr
+ * @return the first node not before bidId, or nullptr
+ */
+SkipList::Node* SkipList::findPredecessors(const string& bidId, Node** update) {
+    Node* current = head;
+    for (int level = height - 1; level >= 0; --level) {
+        while (current->next[level] != nullptr && bidIdLess(current->next[level]->bid.bidId, bidId)) {
+            current = current->next[level];
+        }
+        if (update != nullptr) {
+            update[level] = current;
+        }
+    }
+    return current->next[0];
+}
+
+/**
+ * Insert a bid in bidId order, after any bids with the same id
+ */
+void SkipList::Append(Bid bid) {
+    Node* update[SKIP_LIST_MAX_HEIGHT];
+    Node* current = head;
+    for (int level = height - 1; level >= 0; --level) {
+        while (current->next[level] != nullptr && !bidIdLess(bid.bidId, current->next[level]->bid.bidId)) {
+            current = current->next[level];
+        }
+        update[level] = current;
+    }
+
+    int nodeHeight = randomHeight();
+    for (; height < nodeHeight; ++height) {
+        update[height] = head;
+    }
+    Node* node = newNode(bid, nodeHeight);
+    for (int level = 0; level < nodeHeight; ++level) {
+        node->next[level] = update[level]->next[level];
+        update[level]->next[level] = node;
+    }
+    size++;
+}
+
+/**
+ * Output of all bids in bidId order
+ */
+void SkipList::PrintList() {
+    for (Node* current = head->next[0]; current != nullptr; current = current->next[0]) {
+        cout << current->bid.bidId << ": " << current->bid.title << " | "
+             << current->bid.amount << " | " << current->bid.fund << endl;
+    }
+}
+
+/**
+ * All bids with ids from fromId through toId, in bidId order
+ */
+vector<Bid> SkipList::Range(string fromId, string toId) {
+    vector<Bid> bids;
+    for (Node* current = findPredecessors(fromId, nullptr);
+            current != nullptr && !bidIdLess(toId, current->bid.bidId); current = current->next[0]) {
+        bids.push_back(current->bid);
+    }
+    return bids;
+}
+
+/**
+ * Remove the first bid with the given id
+ *
+ * @param bidId The bid id to remove
+ */
+void SkipList::Remove(string bidId) {
+    Node* update[SKIP_LIST_MAX_HEIGHT];
+    Node* node = findPredecessors(bidId, update);
+    if (node == nullptr || node->bid.bidId != bidId) {
+        return;
+    }
+    for (int level = 0; level < node->height; ++level) {
+        update[level]->next[level] = node->next[level];
+    }
+    while (height > 1 && head->next[height - 1] == nullptr) {
+        height--;
+    }
+
+    node->bid = Bid();
+    node->next[0] = freeNodes[node->height];
+    freeNodes[node->height] = node;
+    size--;
+}
+
+/**
+ * Search for the specified bidId
+ *
+ * @param bidId The bid id to search for
+ * @return the first matching bid, or an empty bid if none matches
+ */
+Bid SkipList::Search(string bidId) {
+    Node* node = findPredecessors(bidId, nullptr);
+    if (node != nullptr && node->bid.bidId == bidId) {
+        return node->bid;
+    }
+    Bid emptyBid;
+    return emptyBid;
+}
+
+/**
+ * Returns the current size (number of elements) in the list
+ */
+int SkipList::Size() {
+    return size;
+}
+
+//============================================================================
+// Lock-free concurrent linked-list class definition
+//============================================================================
+
+/**
+ * Linked list that loader threads can Append and Prepend to while other
+ * threads Search and Remove, without locks.
+ *
+ * Links are CASed: Prepend on the head sentinel's next, Append on the last
+ * node's next with tail as a hint that may lag and is helped along.
+ * Remove is Harris-style: it first sets the low bit of the node's next
+ * (logical delete), and the node is unlinked by whichever thread next
+ * gets a CAS on its predecessor in. A removed node with nothing after it
+ * stays linked until an Append gives it a successor, so appends are never
+ * lost behind it.
+ *
+ * Unlinked nodes are retired to the remover's slot, tagged with the
+ * global epoch, and freed two epochs later, when no thread can still be
+ * reading them. Tail lags the last node by at most one, since Prepend
+ * helps it off the head sentinel just as Append does, and it is moved
+ * past a node before the node is retired. A stale helping CAS on tail
+ * can then only fail, so no thread reaches a retired node through tail
+ * either.
+ */
+class ConcurrentLinkedList {
+
+private:
+    struct Node {
+        Bid bid;
+        atomic<uintptr_t> next; // successor, low bit set once removed
+
+        Node(const Bid& aBid) : bid(aBid), next(0) {}
+    };
+
+    static constexpr uintptr_t MARK = 1;
+    static constexpr uint64_t IDLE = UINT64_MAX;
+
+    // reclamation state, claimed by a thread for each operation
+    struct alignas(64) ThreadSlot {
+        atomic<bool> claimed{false};
+        atomic<uint64_t> epoch{IDLE};
+        vector<Node*> retired[3];
+        uint64_t retiredEpoch[3] = {};
+        int retiredSinceAdvance = 0;
+    };
+
+    Node* head; // sentinel, never removed
+    atomic<Node*> tail;
+    atomic<int> size{0};
+    atomic<uint64_t> globalEpoch{0};
+    ThreadSlot slots[CONCURRENT_LIST_MAX_THREADS];
+
+    static Node* pointer(uintptr_t link) {
+        return reinterpret_cast<Node*>(link & ~MARK);
+    }
+    static bool marked(uintptr_t link) {
+        return link & MARK;
+    }
+
+    ThreadSlot& enter();
+    void exit(ThreadSlot& slot);
+    void retire(ThreadSlot& slot, Node* node);
+    void reclaim(ThreadSlot& slot);
+    void tryAdvanceEpoch();
+    void advanceTail(Node* node);
+    Node* find(const string& bidId, Node*& pred, ThreadSlot& slot);
+
+public:
+    ConcurrentLinkedList();
+    virtual ~ConcurrentLinkedList();
+    void Append(Bid bid);
+    void Prepend(Bid bid);
+    void PrintList();
+    void Remove(string bidId);
+    Bid Search(string bidId);
+    int Size();
+
+    friend void replayConcurrentListRaces();
+};
+
 /**
  * Default constructor
  */
-LinkedList::LinkedList() {
-   head = nullptr;
-   tail = nullptr;
+ConcurrentLinkedList::ConcurrentLinkedList() {
+    head = new Node(Bid());
+    tail = head;
 }
 
 /**
- * Destructor
+ * Destructor; no other thread may be using the list
  */
-LinkedList::~LinkedList() {
+ConcurrentLinkedList::~ConcurrentLinkedList() {
     Node* current = head;
-    Node* temp;
-    while (current != nullptr) { // loop over each node, detach from list then delete
-        temp = current; // hang on to current node
-        current = current->next; // make current the next node
-        delete temp; // delete the orphan node
+    while (current != nullptr) {
+        Node* next = pointer(current->next.load());
+        delete current;
+        current = next;
+    }
+    for (ThreadSlot& slot : slots) {
+        for (vector<Node*>& retired : slot.retired) {
+            for (Node* node : retired) {
+                delete node;
+            }
+        }
     }
-    
- head = nullptr;  // list is now empty
- tail = nullptr;
-
 }
 
 /**
- * Append a new bid to the end of the list
+ * Claim a slot (the one this thread used last, if free) and pin it to
+ * the current epoch, freeing what it retired two or more epochs ago
  */
+ConcurrentLinkedList::ThreadSlot& ConcurrentLinkedList::enter() {
+    thread_local int slotHint = 0;
+    int i = slotHint;
+    for (;; i = (i + 1) % CONCURRENT_LIST_MAX_THREADS) {
+        bool expected = false;
+        if (!slots[i].claimed.load() && slots[i].claimed.compare_exchange_strong(expected, true)) {
+            break;
+        }
+    }
+    slotHint = i;
 
+    ThreadSlot& slot = slots[i];
+    for (;;) {
+        uint64_t epoch = globalEpoch.load();
+        slot.epoch.store(epoch);
+        if (globalEpoch.load() == epoch) {
+            break;
+        }
+    }
+    reclaim(slot);
+    return slot;
+}
 
 /**
- * Prepend a new bid to the start of the list
+ * Unpin and release the slot
  */
-void LinkedList::Prepend(Bid bid) {
-     Node* newNode = new Node(bid);// Create new node
+void ConcurrentLinkedList::exit(ThreadSlot& slot) {
+    slot.epoch.store(IDLE);
+    slot.claimed.store(false);
+}
 
-    if (head != nullptr) {// if there is already something at the head...
-    
-        newNode->next = head; // new node points to current head as its next node
-        head = newNode; // head now becomes the new node
-      }else {
-        head = newNode; // head is equal to new node
-        tail = newNode; // tail is equal to new node
-      }
-    size++; //increase size count
+/**
+ * Free nodes retired at least two epochs before the slot's epoch
+ */
+void ConcurrentLinkedList::reclaim(ThreadSlot& slot) {
+    uint64_t epoch = slot.epoch.load();
+    for (int b = 0; b < 3; ++b) {
+        if (slot.retired[b].empty() || slot.retiredEpoch[b] + 2 > epoch) {
+            continue;
+        }
+        for (Node* node : slot.retired[b]) {
+            delete node;
+        }
+        slot.retired[b].clear();
+    }
 }
 
+/**
+ * Queue an unlinked node for freeing once the epoch has moved on. The
+ * tag is the global epoch, which may already be one past the slot's.
+ */
+void ConcurrentLinkedList::retire(ThreadSlot& slot, Node* node) {
+    advanceTail(node);
+    uint64_t epoch = globalEpoch.load();
+    int b = epoch % 3;
+    slot.retiredEpoch[b] = max(slot.retiredEpoch[b], epoch);
+    slot.retired[b].push_back(node);
+    if (++slot.retiredSinceAdvance >= CONCURRENT_LIST_RETIRE_BATCH) {
+        slot.retiredSinceAdvance = 0;
+        tryAdvanceEpoch();
+    }
+}
 
 /**
- * Simple output of all bids in the list
+ * Move to the next epoch once every active thread has seen this one
  */
-void LinkedList::PrintList() {
-     Node* current = head;// start at the head
-    while (current != nullptr) {// while loop over each node looking for a match
-        cout << current->bid.bidId << ": " 
-        << current->bid.title << " | "
-        << current->bid.amount << " | " 
-        << current->bid.fund << endl;//output current bidID, title, amount and fund
-        current = current->next;//set current equal to next
+void ConcurrentLinkedList::tryAdvanceEpoch() {
+    uint64_t epoch = globalEpoch.load();
+    for (ThreadSlot& slot : slots) {
+        uint64_t seen = slot.epoch.load();
+        if (seen != IDLE && seen != epoch) {
+            return;
+        }
+    }
+    globalEpoch.compare_exchange_strong(epoch, epoch + 1);
 }
+
+/**
+ * If tail is on an unlinked node, move it to the node's successor, and
+ * on past any successors unlinked as well. An unlinked node always has
+ * a successor.
+ */
+void ConcurrentLinkedList::advanceTail(Node* node) {
+    for (;;) {
+        uintptr_t link = node->next.load();
+        Node* succ = pointer(link);
+        if (!marked(link) || succ == nullptr || !tail.compare_exchange_strong(node, succ)) {
+            return; // live, still linked, or tail is elsewhere
+        }
+        node = succ;
+    }
 }
 
 /**
- * Remove a specified bid
+ * First live node with the given id, unlinking removed nodes on the way
  *
- * @param bidId The bid id to remove from the list
+ * @param pred receives the node before it
+ * @return the node, or nullptr if there is none
  */
+ConcurrentLinkedList::Node* ConcurrentLinkedList::find(const string& bidId, Node*& pred, ThreadSlot& slot) {
+retry:
+    pred = head;
+    Node* current = pointer(head->next.load());
+    while (current != nullptr) {
+        uintptr_t link = current->next.load();
+        Node* succ = pointer(link);
+        if (!marked(link)) {
+            if (current->bid.bidId == bidId) {
+                return current;
+            }
+            pred = current;
+        } else if (succ != nullptr) {
+            uintptr_t expected = reinterpret_cast<uintptr_t>(current);
+            if (!pred->next.compare_exchange_strong(expected, reinterpret_cast<uintptr_t>(succ))) {
+                goto retry; // pred changed or was removed itself
+            }
+            retire(slot, current);
+        }
+        current = succ;
+    }
+    return nullptr;
+}
 
-
-void LinkedList::Remove(string bidId) {
-    // Special case: head matches
-    if (head != nullptr && head->bid.bidId == bidId) {
-        Node* temp = head;
-        head = head->next; // move head to next node
-        if (head == nullptr) {
-            tail = nullptr; // list is now empty
+/**
+ * Append a new bid to the end of the list
+ */
+void ConcurrentLinkedList::Append(Bid bid) {
+    Node* node = new Node(bid);
+    size++;
+    ThreadSlot& slot = enter();
+    for (;;) {
+        Node* last = tail.load();
+        uintptr_t link = last->next.load();
+        if (pointer(link) != nullptr) { // tail is behind: help it along
+            tail.compare_exchange_strong(last, pointer(link));
+            continue;
+        }
+        // a removed last node keeps its mark on the new link
+        if (last->next.compare_exchange_strong(link, reinterpret_cast<uintptr_t>(node) | (link & MARK))) {
+            tail.compare_exchange_strong(last, node);
+            break;
         }
-        delete temp; // free memory
-        size--; // decrease size count
-        return;
     }
+    exit(slot);
+}
 
-    // Traverse the list
-    Node* current = head;
-    while (current != nullptr && current->next != nullptr) {
-        if (current->next->bid.bidId == bidId) {
-            Node* temp = current->next; // hold onto the next node
-            current->next = temp->next; // bypass the node
-            if (temp == tail) {
-                tail = current; // update tail if last node removed
-            }
-            delete temp; // free memory
-            size--; // decrease size count
-            return;
+/**
+ * Prepend a new bid to the start of the list
+ */
+void ConcurrentLinkedList::Prepend(Bid bid) {
+    Node* node = new Node(bid);
+    size++;
+    ThreadSlot& slot = enter();
+    Node* last = head;
+    uintptr_t first = head->next.load();
+    if (tail.load() == head && pointer(first) != nullptr) { // tail is behind: help it along
+        tail.compare_exchange_strong(last, pointer(first));
+    }
+    do {
+        node->next.store(first);
+    } while (!head->next.compare_exchange_weak(first, reinterpret_cast<uintptr_t>(node)));
+    exit(slot);
+}
+
+/**
+ * Output of all bids not removed
+ */
+void ConcurrentLinkedList::PrintList() {
+    ThreadSlot& slot = enter();
+    for (Node* current = pointer(head->next.load()); current != nullptr;) {
+        uintptr_t link = current->next.load();
+        if (!marked(link)) {
+            cout << current->bid.bidId << ": " << current->bid.title << " | "
+                 << current->bid.amount << " | " << current->bid.fund << endl;
         }
-        current = current->next; // move to next node
+        current = pointer(link);
     }
+    exit(slot);
 }
 
+/**
+ * Remove the first bid with the given id
+ *
+ * @param bidId The bid id to remove from the list
+ */
+void ConcurrentLinkedList::Remove(string bidId) {
+    ThreadSlot& slot = enter();
+    for (;;) {
+        Node* pred;
+        Node* node = find(bidId, pred, slot);
+        if (node == nullptr) {
+            break;
+        }
+        uintptr_t link = node->next.load();
+        if (marked(link) || !node->next.compare_exchange_strong(link, link | MARK)) {
+            continue; // another thread got there first: look again
+        }
+        size--;
 
+        // try to unlink now; otherwise a later find will
+        Node* succ = pointer(link);
+        uintptr_t expected = reinterpret_cast<uintptr_t>(node);
+        if (succ != nullptr && pred->next.compare_exchange_strong(expected, reinterpret_cast<uintptr_t>(succ))) {
+            retire(slot, node);
+        }
+        break;
+    }
+    exit(slot);
+}
 
 /**
  * Search for the specified bidId
  *
  * @param bidId The bid id to search for
+ * @return the first matching bid, or an empty bid if none matches
  */
-Bid LinkedList::Search(string bidId) {
-    // special case if matching bid is the head
-    Node*current = head;// start at the head of the list
-    while(current != nullptr) { // keep searching until end reached with while loop (current != nullptr)
-        if(current->bid.bidId == bidId) {   // if current node bidID is equal to search bidID
-            return current->bid; // return the current bid
-        } else {
-            current = current->next; // else current node is equal to next node
+Bid ConcurrentLinkedList::Search(string bidId) {
+    Bid bid;
+    ThreadSlot& slot = enter();
+    for (Node* current = pointer(head->next.load()); current != nullptr;) {
+        uintptr_t link = current->next.load();
+        if (!marked(link) && current->bid.bidId == bidId) {
+            bid = current->bid;
+            break;
         }
+        current = pointer(link);
     }
-    //(the next two statements will only execute if search item is not found)
-       Bid emptyBid; //create new empty bid
-        return emptyBid;// return the empty bid 
+    exit(slot);
+    return bid;
 }
 
 /**
- * Returns the current size (number of elements) in the list
+ * Returns the current size (number of bids not removed)
  */
-int LinkedList::Size() {
-    return size;
+int ConcurrentLinkedList::Size() {
+    return size.load();
 }
 
 //============================================================================
@@ -246,11 +1513,12 @@ Bid getBid() {
 }
 
 /**
- * Load a CSV file containing bids into a LinkedList
+ * Read the bids in a CSV file
  *
- * @return a LinkedList containing all the bids read
+ * @return the bids read, in file order
  */
-void loadBids(string csvPath, LinkedList *list) {
+vector<Bid> readBids(string csvPath) {
+    vector<Bid> bids;
     cout << "Loading CSV file " << csvPath << endl;
 
     // initialize the CSV Parser
@@ -270,11 +1538,335 @@ void loadBids(string csvPath, LinkedList *list) {
             //cout << bid.bidId << ": " << bid.title << " | " << bid.fund << " | " << bid.amount << endl;
 
             // add this bid to the end
-            list->Append(bid);
+            bids.push_back(bid);
         }
     } catch (csv::Error &e) {
         std::cerr << e.what() << std::endl;
     }
+    return bids;
+}
+
+/**
+ * Load a CSV file containing bids into an UnrolledLinkedList, one Append
+ * per bid
+ */
+template <typename List>
+void loadBids(string csvPath, List *list) {
+    for (const Bid& bid : readBids(csvPath)) {
+        list->Append(bid);
+    }
+}
+
+/**
+ * Load a CSV file containing bids into a LinkedList as one chain
+ */
+void loadBids(string csvPath, LinkedList *list) {
+    list->AppendAll(readBids(csvPath));
+}
+
+/**
+ * Time full-length scans (searches for an id that is not there) over the
+ * same bids held in both list layouts
+ *
+ * @param csvPath the CSV file to load into both lists
+ */
+void compareListLayouts(string csvPath) {
+    const int scans = 100;
+    LinkedList linked;
+    UnrolledLinkedList unrolled;
+    loadBids(csvPath, &linked);
+    loadBids(csvPath, &unrolled);
+
+    clock_t ticks = clock();
+    for (int i = 0; i < scans; ++i) {
+        linked.Search("not a bid id");
+    }
+    ticks = clock() - ticks;
+    cout << scans << " scans of " << linked.Size() << " linked nodes: " << ticks << " clock ticks" << endl;
+
+    ticks = clock();
+    for (int i = 0; i < scans; ++i) {
+        unrolled.Search("not a bid id");
+    }
+    ticks = clock() - ticks;
+    cout << scans << " scans of " << unrolled.Size() << " unrolled bids: " << ticks << " clock ticks" << endl;
+}
+
+/**
+ * Time Append and Search on a LinkedList and a SkipList of random bids at
+ * 100k, 1M and 10M elements (up to maxSize). The linked list only gets a
+ * few searches per size since each one is a full scan.
+ *
+ * @param maxSize largest number of bids to try
+ */
+void compareSkipList(int maxSize) {
+    const int listSearches = 20;
+    const int skipSearches = 100000;
+
+    for (int n = 100000; n <= maxSize; n *= 10) {
+        mt19937 rng(n);
+        vector<string> ids(n);
+        for (string& id : ids) {
+            id = to_string(rng() % 100000000);
+        }
+        Bid bid;
+        bid.title = "Benchmark bid";
+        bid.fund = "General Fund";
+
+        {
+            LinkedList list;
+            clock_t ticks = clock();
+            for (const string& id : ids) {
+                bid.bidId = id;
+                list.Append(bid);
+            }
+            ticks = clock() - ticks;
+            cout << n << " bids, LinkedList: append " << ticks * 1.0 / CLOCKS_PER_SEC << " s";
+
+            ticks = clock();
+            for (int i = 0; i < listSearches; ++i) {
+                list.Search(ids[rng() % n]);
+            }
+            ticks = clock() - ticks;
+            cout << ", search " << ticks * 1e6 / CLOCKS_PER_SEC / listSearches << " us each" << endl;
+        }
+        {
+            SkipList list;
+            clock_t ticks = clock();
+            for (const string& id : ids) {
+                bid.bidId = id;
+                list.Append(bid);
+            }
+            ticks = clock() - ticks;
+            cout << n << " bids, SkipList: append " << ticks * 1.0 / CLOCKS_PER_SEC << " s";
+
+            ticks = clock();
+            for (int i = 0; i < skipSearches; ++i) {
+                list.Search(ids[rng() % n]);
+            }
+            ticks = clock() - ticks;
+            cout << ", search " << ticks * 1e6 / CLOCKS_PER_SEC / skipSearches << " us each" << endl;
+        }
+    }
+}
+
+/**
+ * Replay, step by step on one thread, two interleavings the concurrent
+ * list's reclamation must survive, and report whether the node in
+ * question was still allocated when the other thread used it:
+ *  - a remover pinned at epoch e retires a node that a reader pinned at
+ *    e + 1 is standing on, then the epoch advances past the reader's
+ *  - a searcher unlinks and retires the removed last node while its
+ *    appender has yet to move tail off it, and a third thread reads tail
+ *  - an appender reads tail and its successor, a node prepended earlier
+ *    is removed and retired, then the appender helps tail along and a
+ *    third thread reads tail
+ */
+void replayConcurrentListRaces() {
+    typedef ConcurrentLinkedList List;
+    Bid bid;
+
+    // pin a slot that was claimed and released before, as enter() would
+    auto repin = [](List& list, List::ThreadSlot& slot) {
+        slot.claimed.store(true);
+        slot.epoch.store(list.globalEpoch.load());
+        list.reclaim(slot);
+    };
+    auto retired = [](List::ThreadSlot& slot, List::Node* node) {
+        for (vector<List::Node*>& nodes : slot.retired) {
+            if (find(nodes.begin(), nodes.end(), node) != nodes.end()) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    {
+        List list;
+        for (const char* id : { "1", "2", "3" }) {
+            bid.bidId = id;
+            list.Append(bid);
+        }
+        List::ThreadSlot& remover = list.enter();
+        list.tryAdvanceEpoch();
+        List::ThreadSlot& reader = list.enter();
+        List::Node* node = List::pointer(List::pointer(list.head->next.load())->next.load());
+
+        List::Node* pred;
+        list.find("2", pred, remover);
+        uintptr_t link = node->next.load();
+        node->next.store(link | List::MARK);
+        uintptr_t expected = reinterpret_cast<uintptr_t>(node);
+        pred->next.compare_exchange_strong(expected, link);
+        list.retire(remover, node);
+        list.exit(remover);
+
+        list.tryAdvanceEpoch();
+        repin(list, remover);
+        bool kept = retired(remover, node);
+        if (kept) {
+            List::pointer(node->next.load()); // the reader moves on
+        }
+        list.exit(remover);
+        list.exit(reader);
+        cout << "  reader pinned after the remover: " << (kept ? "ok" : "FAILED, node freed under the reader") << endl;
+    }
+
+    {
+        List list;
+        for (const char* id : { "1", "2" }) {
+            bid.bidId = id;
+            list.Append(bid);
+        }
+        List::Node* last = list.tail.load();
+        list.Remove("2"); // last node: marked but left linked
+
+        // an appender links its node but has not moved tail yet
+        List::ThreadSlot& appender = list.enter();
+        bid.bidId = "3";
+        List::Node* node = new List::Node(bid);
+        uintptr_t link = last->next.load();
+        last->next.compare_exchange_strong(link, reinterpret_cast<uintptr_t>(node) | List::MARK);
+
+        // a search unlinks and retires the removed node
+        List::ThreadSlot& searcher = list.enter();
+        List::Node* pred;
+        list.find("none", pred, searcher);
+        list.exit(searcher);
+
+        list.tryAdvanceEpoch();
+        List::ThreadSlot& reader = list.enter();
+        List::Node* seen = list.tail.load();
+
+        // the appender finishes
+        List::Node* expected = last;
+        list.tail.compare_exchange_strong(expected, node);
+        list.exit(appender);
+
+        list.tryAdvanceEpoch();
+        repin(list, searcher);
+        bool safe = seen != last || retired(searcher, last);
+        if (safe) {
+            seen->next.load(); // the reader appends after what it saw
+        }
+        list.exit(searcher);
+        list.exit(reader);
+        cout << "  tail read after its node was retired: " << (safe ? "ok" : "FAILED, node freed under the reader") << endl;
+    }
+
+    {
+        List list;
+        for (const char* id : { "1", "2" }) {
+            bid.bidId = id;
+            list.Prepend(bid); // head -> 2 -> 1
+        }
+
+        // an appender reads tail and what follows it, then stalls
+        List::ThreadSlot& appender = list.enter();
+        List::Node* last = list.tail.load();
+        uintptr_t link = last->next.load();
+
+        // the first node is removed, unlinked and retired
+        List::ThreadSlot& remover = list.enter();
+        List::Node* pred;
+        List::Node* node = list.find("2", pred, remover);
+        uintptr_t next = node->next.load();
+        node->next.store(next | List::MARK);
+        uintptr_t expected = reinterpret_cast<uintptr_t>(node);
+        pred->next.compare_exchange_strong(expected, next);
+        list.retire(remover, node);
+        list.exit(remover);
+
+        // the appender resumes by helping tail along, as Append does
+        if (List::pointer(link) != nullptr) {
+            list.tail.compare_exchange_strong(last, List::pointer(link));
+        }
+        list.exit(appender);
+
+        list.tryAdvanceEpoch();
+        List::ThreadSlot& reader = list.enter();
+        List::Node* seen = list.tail.load();
+        bool safe = !retired(remover, seen);
+
+        list.tryAdvanceEpoch();
+        repin(list, remover);
+        if (safe) {
+            seen->next.load(); // the reader appends after what it saw
+        }
+        list.exit(remover);
+        list.exit(reader);
+        cout << "  tail helped onto a prepended node after it was retired: "
+             << (safe ? "ok" : "FAILED, node freed under the reader") << endl;
+    }
+}
+
+/**
+ * Stress the concurrent list: writer threads append and prepend their own
+ * bid ids and remove every fourth one again, while reader threads search
+ * random ids. Reports throughput and checks the final contents.
+ *
+ * @param writers number of writer threads
+ * @param readers number of reader threads
+ * @param bidsPerWriter bids each writer adds
+ */
+void stressConcurrentList(int writers, int readers, int bidsPerWriter) {
+    ConcurrentLinkedList list;
+    atomic<int> writersDone{0};
+    atomic<long long> searches{0};
+    int total = writers * bidsPerWriter;
+
+    auto start = chrono::steady_clock::now();
+    vector<thread> threads;
+    for (int w = 0; w < writers; ++w) {
+        threads.emplace_back([&list, &writersDone, w, bidsPerWriter]() {
+            Bid bid;
+            bid.title = "Stress bid";
+            bid.fund = "General Fund";
+            for (int i = 0; i < bidsPerWriter; ++i) {
+                bid.bidId = to_string(w * bidsPerWriter + i);
+                if (i % 2 == 0) {
+                    list.Append(bid);
+                } else {
+                    list.Prepend(bid);
+                }
+                if (i % 4 == 3) {
+                    list.Remove(to_string(w * bidsPerWriter + i - 2));
+                }
+            }
+            writersDone++;
+        });
+    }
+    for (int r = 0; r < readers; ++r) {
+        threads.emplace_back([&list, &writersDone, &searches, writers, total, r]() {
+            mt19937 rng(r);
+            long long count = 0;
+            while (writersDone.load() < writers) {
+                list.Search(to_string(rng() % total));
+                count++;
+            }
+            searches += count;
+        });
+    }
+    for (thread& t : threads) {
+        t.join();
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    int removed = writers * (bidsPerWriter / 4);
+    int expected = total - removed;
+    int missing = 0;
+    int resurrected = 0;
+    for (int id = 0; id < total; ++id) {
+        bool isRemoved = id % bidsPerWriter % 4 == 1 && id % bidsPerWriter + 2 < bidsPerWriter / 4 * 4;
+        bool found = list.Search(to_string(id)).bidId == to_string(id);
+        missing += !isRemoved && !found;
+        resurrected += isRemoved && found;
+    }
+
+    cout << writers << " writers, " << readers << " readers: " << seconds << " s" << endl;
+    cout << "  " << (total + removed) / seconds << " writes/s, " << searches.load() / seconds << " searches/s" << endl;
+    cout << "  size " << list.Size() << " (expected " << expected << "), " << missing << " missing, "
+         << resurrected << " removed bids still found" << endl;
 }
 
 /**
@@ -328,6 +1920,14 @@ int main(int argc, char* argv[]) {
         cout << "  3. Display All Bids" << endl;
         cout << "  4. Find Bid" << endl;
         cout << "  5. Remove Bid" << endl;
+        cout << "  6. Compare List Layouts" << endl;
+        cout << "  7. Turn Bid Id Index " << (bidList.Indexed() ? "Off" : "On") << endl;
+        cout << "  8. Compare Skip List" << endl;
+        cout << "  10. Concurrent List Stress Test" << endl;
+        cout << "  11. Set Search Mode" << endl;
+        cout << "  12. Remove Many Bids" << endl;
+        cout << "  13. Sort Bids" << endl;
+        cout << "  14. Merge Another Bid File" << endl;
         cout << "  9. Exit" << endl;
         cout << "Enter choice: ";
         cin >> choice;
@@ -373,6 +1973,9 @@ int main(int argc, char* argv[]) {
 
             cout << "time: " << ticks << " clock ticks" << endl;
             cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+            if (bidList.GetSearchPolicy() != SEARCH_FIXED) {
+                cout << "average search depth: " << bidList.AverageSearchDepth() << endl;
+            }
 
             break;
 
@@ -380,6 +1983,110 @@ int main(int argc, char* argv[]) {
             bidList.Remove(bidKey);
 
             break;
+
+        case 6:
+            compareListLayouts(csvPath);
+
+            break;
+
+        case 7:
+            ticks = clock();
+            bidList.SetIndexed(!bidList.Indexed());
+            ticks = clock() - ticks;
+            cout << "Bid id index " << (bidList.Indexed() ? "on" : "off") << endl;
+            cout << "time: " << ticks << " clock ticks" << endl;
+
+            break;
+
+        case 8: {
+            int maxSize = 1000000;
+            cout << "Enter largest size (up to 10000000): ";
+            cin >> maxSize;
+            compareSkipList(maxSize);
+
+            break;
+        }
+
+        case 10: {
+            int writers = 4, readers = 4, bidsPerWriter = 10000;
+            cout << "Enter writer threads, reader threads and bids per writer: ";
+            cin >> writers >> readers >> bidsPerWriter;
+            cout << "Replaying reclamation races" << endl;
+            replayConcurrentListRaces();
+            stressConcurrentList(writers, readers, bidsPerWriter);
+
+            break;
+        }
+
+        case 11: {
+            int mode = 1;
+            cout << "Search mode 1. Fixed, 2. Move to Front or 3. Transpose: ";
+            cin >> mode;
+            bidList.SetSearchPolicy(mode == 2 ? SEARCH_MOVE_TO_FRONT : mode == 3 ? SEARCH_TRANSPOSE : SEARCH_FIXED);
+
+            break;
+        }
+
+        case 12: {
+            vector<string> bidIds;
+            string line, bidId;
+            cout << "Enter bid ids separated by spaces: ";
+            cin.ignore();
+            getline(cin, line);
+            istringstream ids(line);
+            while (ids >> bidId) {
+                bidIds.push_back(bidId);
+            }
+
+            ticks = clock();
+            int removed = bidList.RemoveAll(bidIds);
+            ticks = clock() - ticks;
+
+            cout << removed << " bids removed" << endl;
+            cout << "time: " << ticks << " clock ticks" << endl;
+
+            break;
+        }
+
+        case 13: {
+            int field = 1;
+            cout << "Sort by 1. Title, 2. Amount or 3. Bid Id: ";
+            cin >> field;
+
+            ticks = clock();
+            bidList.Sort(field == 2 ? SORT_BY_AMOUNT : field == 3 ? SORT_BY_BID_ID : SORT_BY_TITLE);
+            ticks = clock() - ticks;
+
+            cout << bidList.Size() << " bids sorted" << endl;
+            cout << "time: " << ticks << " clock ticks" << endl;
+            cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
+
+            break;
+        }
+
+        case 14: {
+            string morePath;
+            cout << "Enter CSV path: ";
+            cin.ignore();
+            getline(cin, morePath);
+
+            LinkedList month;
+            try {
+                loadBids(morePath, &month);
+            } catch (csv::Error &e) {
+                std::cerr << e.what() << std::endl;
+                break;
+            }
+
+            ticks = clock();
+            bidList.Splice(move(month));
+            ticks = clock() - ticks;
+
+            cout << bidList.Size() << " bids after merge" << endl;
+            cout << "time: " << ticks << " clock ticks" << endl;
+
+            break;
+        }
         }
     }
 
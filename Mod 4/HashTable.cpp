@@ -8,12 +8,31 @@
 
 #include <algorithm>
 #include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
 #include <iostream>
+#include <new>
+#include <sstream>
 #include <string> // atoi
 #include <time.h>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "CSVparser.hpp"
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// CRC32C instruction for the CRC32C hash policy (GCC and Clang on x86-64)
+#if defined(__GNUC__) && defined(__x86_64__)
+#define CRC32C_SSE42 1
+#include <nmmintrin.h>
+#endif
+
 using namespace std;
 
 //============================================================================
@@ -22,6 +41,24 @@ using namespace std;
 
 const unsigned int DEFAULT_SIZE = 179;
 
+// the chained table grows past this many bids per bucket, and shrinks
+// below a quarter of it
+const double DEFAULT_MAX_LOAD_FACTOR = 1.0;
+
+// buckets moved to the resized table on each operation while rehashing
+const unsigned int REHASH_BUCKETS_PER_OP = 8;
+
+// bytes carved into chain nodes per pool slab
+const size_t NODE_POOL_SLAB_BYTES = 64 * 1024;
+
+// open-addressing control bytes; a full slot holds the low 7 bits of its hash
+const int8_t SWISS_EMPTY = -128;
+const int8_t SWISS_DELETED = -2;
+
+// slots probed together, and the smallest open-addressing table
+const size_t SWISS_GROUP_SIZE = 16;
+const size_t SWISS_MIN_CAPACITY = 256;
+
 // forward declarations
 double strToDouble(string str, char ch);
 
@@ -36,6 +73,220 @@ struct Bid {
     }
 };
 
+//============================================================================
+// Pooled node allocator
+//============================================================================
+
+/**
+ * Hands out nodes carved from large slabs instead of one heap block per
+ * node. Freed nodes go on an intrusive free list and are reused first;
+ * the slabs are returned only when the pool is destroyed, one free per
+ * slab.
+ */
+template <typename T>
+class NodePool {
+
+private:
+    // a free slot reuses the node's own storage as the free-list link
+    union Slot {
+        Slot* nextFree;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    static const size_t SLAB_NODES = NODE_POOL_SLAB_BYTES / sizeof(Slot) > 0 ? NODE_POOL_SLAB_BYTES / sizeof(Slot) : 1;
+
+    vector<Slot*> slabs;
+    Slot* freeList = nullptr;
+    size_t slabUsed = SLAB_NODES; // slots handed out from the newest slab
+
+public:
+    NodePool() {}
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    /**
+     * Destructor; nodes still in use must have been Delete()d already
+     */
+    ~NodePool() {
+        for (Slot* slab : slabs) {
+            delete[] slab;
+        }
+    }
+
+    /**
+     * Construct a node in a recycled slot, or the next slot of the newest
+     * slab
+     */
+    template <typename... Args>
+    T* New(Args&&... args) {
+        Slot* slot;
+        if (freeList != nullptr) {
+            slot = freeList;
+            freeList = freeList->nextFree;
+        } else {
+            if (slabUsed == SLAB_NODES) {
+                slabs.push_back(new Slot[SLAB_NODES]);
+                slabUsed = 0;
+            }
+            slot = &slabs.back()[slabUsed++];
+        }
+        return new (slot->storage) T(forward<Args>(args)...);
+    }
+
+    /**
+     * Destroy a node and put its slot on the free list
+     */
+    void Delete(T* node) {
+        node->~T();
+        Slot* slot = reinterpret_cast<Slot*>(node);
+        slot->nextFree = freeList;
+        freeList = slot;
+    }
+};
+
+//============================================================================
+// Hash policies
+//============================================================================
+
+/**
+ * The bid id's number itself, the table's original hash
+ */
+struct IdHash {
+    size_t operator()(const string& bidId) const {
+        return unsigned(atoi(bidId.c_str()));
+    }
+};
+
+/**
+ * FNV-1a over the id's characters
+ */
+struct Fnv1aHash {
+    size_t operator()(const string& bidId) const {
+        uint64_t hash = 14695981039346656037ull;
+        for (unsigned char ch : bidId) {
+            hash = (hash ^ ch) * 1099511628211ull;
+        }
+        return hash;
+    }
+};
+
+/**
+ * Multiply two 64-bit words and fold the 128-bit product
+ */
+inline uint64_t foldedMultiply(uint64_t a, uint64_t b) {
+#ifdef __SIZEOF_INT128__
+    __uint128_t product = (__uint128_t)a * b;
+    return uint64_t(product) ^ uint64_t(product >> 64);
+#else
+    uint64_t low = a * b;
+    uint64_t high = (a >> 32) * (b >> 32) + (((a >> 32) * uint32_t(b) + uint32_t(a) * (b >> 32)) >> 32);
+    return low ^ high;
+#endif
+}
+
+/**
+ * wyhash-style: eight bytes at a time, each mixed in with one folded
+ * 64x64-bit multiply
+ */
+struct WyMixHash {
+    size_t operator()(const string& bidId) const {
+        const uint64_t p0 = 0xa0761d6478bd642full;
+        const uint64_t p1 = 0xe7037ed1a0b428dbull;
+        const char* bytes = bidId.data();
+        size_t length = bidId.size();
+        uint64_t seed = p0 ^ length;
+        size_t i = 0;
+        for (; i + 8 <= length; i += 8) {
+            uint64_t word;
+            memcpy(&word, bytes + i, 8);
+            seed = foldedMultiply(word ^ p1, seed ^ p0);
+        }
+        uint64_t tail = 0;
+        memcpy(&tail, bytes + i, length - i);
+        return foldedMultiply(tail ^ p1 ^ length, seed ^ p1);
+    }
+};
+
+#ifdef CRC32C_SSE42
+
+/**
+ * CRC32C with the SSE4.2 crc32 instruction, eight bytes at a time
+ */
+__attribute__((target("sse4.2")))
+uint32_t crc32cHardware(const char* bytes, size_t length, uint32_t crc) {
+    size_t i = 0;
+    uint64_t crc64 = crc;
+    for (; i + 8 <= length; i += 8) {
+        uint64_t word;
+        memcpy(&word, bytes + i, 8);
+        crc64 = _mm_crc32_u64(crc64, word);
+    }
+    crc = uint32_t(crc64);
+    for (; i < length; ++i) {
+        crc = _mm_crc32_u8(crc, bytes[i]);
+    }
+    return crc;
+}
+
+/**
+ * True when the CPU running the program supports SSE4.2
+ */
+bool crc32cHardwareAvailable() {
+    static const bool available = __builtin_cpu_supports("sse4.2");
+    return available;
+}
+
+#endif
+
+/**
+ * CRC32C a byte at a time from a lookup table
+ */
+uint32_t crc32cTable(const char* bytes, size_t length, uint32_t crc) {
+    static const vector<uint32_t> table = [] {
+        vector<uint32_t> entries(256);
+        for (uint32_t n = 0; n < 256; ++n) {
+            uint32_t entry = n;
+            for (int bit = 0; bit < 8; ++bit) {
+                entry = entry & 1 ? (entry >> 1) ^ 0x82f63b78 : entry >> 1;
+            }
+            entries[n] = entry;
+        }
+        return entries;
+    }();
+    for (size_t i = 0; i < length; ++i) {
+        crc = table[(crc ^ (unsigned char)bytes[i]) & 0xff] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+/**
+ * CRC32C of the id; uses the SSE4.2 crc32 instruction when the CPU has
+ * it, otherwise the lookup table
+ */
+struct Crc32cHash {
+    size_t operator()(const string& bidId) const {
+#ifdef CRC32C_SSE42
+        if (crc32cHardwareAvailable()) {
+            return ~crc32cHardware(bidId.data(), bidId.size(), 0xffffffff);
+        }
+#endif
+        return ~crc32cTable(bidId.data(), bidId.size(), 0xffffffff);
+    }
+};
+
+/**
+ * The id's number run through the splitmix64 finalizer; ids that are
+ * not numbers all land in one bucket
+ */
+struct IntegerMixHash {
+    size_t operator()(const string& bidId) const {
+        uint64_t x = strtoull(bidId.c_str(), nullptr, 10);
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+        return x ^ (x >> 31);
+    }
+};
+
 //============================================================================
 // Hash Table class definition
 //============================================================================
@@ -43,7 +294,11 @@ struct Bid {
 /**
  * Define a class containing data members and methods to
  * implement a hash table with chaining.
+ *
+ * Hash maps a bid id to a size_t; the bucket is that modulo the
+ * (prime) bucket count.
  */
+template <typename Hash = IdHash>
 class HashTable {
 
 private:
@@ -72,9 +327,31 @@ private:
 
     vector<Node> nodes;
 
+    // chain nodes past the one stored in each bucket
+    NodePool<Node> pool;
+
     unsigned int tableSize = DEFAULT_SIZE;
 
-    unsigned int hash(int key);
+    // while resizing, buckets of the old table from rehashIndex on have
+    // not been moved into nodes yet
+    vector<Node> oldNodes;
+    unsigned int oldTableSize = 0;
+    unsigned int rehashIndex = 0;
+
+    size_t size = 0;
+    unsigned int minTableSize = DEFAULT_SIZE;
+    double maxLoadFactor = DEFAULT_MAX_LOAD_FACTOR;
+
+    Hash hasher;
+
+    unsigned int hash(const string& bidId);
+    Node* bucket(const string& bidId, unsigned int& key);
+    void append(Node* node);
+    void resize(unsigned int buckets);
+    void rehashStep();
+    void finishRehash();
+    void checkLoad();
+    void printBuckets(vector<Node>& table, unsigned int first);
 
 public:
     HashTable();
@@ -83,14 +360,38 @@ public:
     void Insert(Bid bid);
     void PrintAll();
     void Remove(string bidId);
+    int RemoveAll(const vector<string>& bidIds);
     Bid Search(string bidId);
     size_t Size();
+    unsigned int BucketCount();
+    double LoadFactor();
+    void SetMaxLoadFactor(double loadFactor);
+    vector<size_t> ChainLengths();
 };
 
+/**
+ * Smallest prime number not below n
+ */
+unsigned int nextPrime(unsigned int n) {
+    for (;; ++n) {
+        if (n < 2) {
+            continue;
+        }
+        bool prime = true;
+        for (unsigned int d = 2; d * d <= n && prime; ++d) {
+            prime = n % d != 0;
+        }
+        if (prime) {
+            return n;
+        }
+    }
+}
+
 /**
  * Default constructor
  */
-HashTable::HashTable() {
+template <typename Hash>
+HashTable<Hash>::HashTable() {
     // FIXME (1): Initialize the structures used to hold bids
     tableSize = DEFAULT_SIZE;
     nodes.resize(tableSize);
@@ -102,45 +403,163 @@ HashTable::HashTable() {
  * Use to improve efficiency of hashing algorithm
  * by reducing collisions without wasting memory.
  */
-HashTable::HashTable(unsigned int size) {
+template <typename Hash>
+HashTable<Hash>::HashTable(unsigned int size) {
     // invoke local tableSize to size with this->
+    this->tableSize = max(size, 1u);
     // resize nodes size
+    nodes.resize(tableSize);
+    // never shrink below the size asked for
+    minTableSize = tableSize;
 }
 
 
 /**
  * Destructor
  */
-HashTable::~HashTable() {
+template <typename Hash>
+HashTable<Hash>::~HashTable() {
     // FIXME (2): Implement logic to free storage when class is destroyed
     for(unsigned int i = 0; i < tableSize; i++) {// Loop through each bucket
         Node* current = nodes[i].next;// Skip the head node (stored in vector)
         while(current != nullptr) {
             Node* temp = current;
             current = current->next;
-            delete temp;// Free memory
+            pool.Delete(temp);// Free memory
+        }
+    }
+    for (Node& head : oldNodes) {// and the buckets not yet rehashed
+        while (head.next != nullptr) {
+            Node* temp = head.next;
+            head.next = temp->next;
+            pool.Delete(temp);
         }
     }
    nodes.clear(); // clear vector
 }
 
 /**
- * Calculate the hash value of a given key.
- * Note that key is specifically defined as
- * unsigned int to prevent undefined results
- * of a negative list index.
+ * Calculate the bucket of a given bid id.
+ * The policy's hash is unsigned to prevent
+ * undefined results of a negative list index.
  *
- * @param key The key to hash
- * @return The calculated hash
+ * @param bidId The bid id to hash
+ * @return The calculated bucket
  */
-unsigned int HashTable::hash(int key) {
+template <typename Hash>
+unsigned int HashTable<Hash>::hash(const string& bidId) {
     // FIXME (3): Implement logic to calculate a hash value
- 
-unsigned int hashValue = 0;
-    for (char ch : keyStr) {
-        hashValue = (hashValue * 31) + ch; // simple string hash
+    return hasher(bidId) % tableSize;
+}
+
+/**
+ * The bucket a bid id lives in: in the old table if a resize has not
+ * reached its bucket yet, otherwise in nodes
+ *
+ * @param key receives the bucket's index in its table
+ */
+template <typename Hash>
+typename HashTable<Hash>::Node* HashTable<Hash>::bucket(const string& bidId, unsigned int& key) {
+    size_t hashValue = hasher(bidId);
+    if (!oldNodes.empty()) {
+        key = hashValue % oldTableSize;
+        if (key >= rehashIndex) {
+            return &oldNodes[key];
+        }
+    }
+    key = hashValue % tableSize;
+    return &nodes[key];
+}
+
+/**
+ * Relink a chain node onto the end of its bucket in nodes; a node that
+ * lands in an empty bucket has its bid moved into the bucket instead
+ */
+template <typename Hash>
+void HashTable<Hash>::append(Node* node) {
+    unsigned int key = hash(node->bid.bidId);
+    Node* current = &nodes[key];
+    if (current->key == UINT_MAX) {
+        current->key = key;
+        current->bid = move(node->bid);
+        pool.Delete(node);
+        return;
+    }
+    while (current->next != nullptr) {
+        current = current->next;
+    }
+    node->key = key;
+    node->next = nullptr;
+    current->next = node;
+}
+
+/**
+ * Start moving the bids into a table with the given number of buckets.
+ * The move happens a few buckets per operation in rehashStep().
+ */
+template <typename Hash>
+void HashTable<Hash>::resize(unsigned int buckets) {
+    finishRehash();
+    oldNodes.swap(nodes);
+    oldTableSize = tableSize;
+    rehashIndex = 0;
+    tableSize = buckets;
+    nodes.assign(tableSize, Node());
+}
+
+/**
+ * Move the next REHASH_BUCKETS_PER_OP old buckets into nodes. Chain nodes
+ * are relinked as they are; only the bids stored in the bucket heads are
+ * copied.
+ */
+template <typename Hash>
+void HashTable<Hash>::rehashStep() {
+    for (unsigned int step = 0; step < REHASH_BUCKETS_PER_OP && !oldNodes.empty(); ++step) {
+        Node& head = oldNodes[rehashIndex++];
+        if (head.key != UINT_MAX) {
+            Node* chain = head.next;
+            append(pool.New(move(head.bid)));
+            while (chain != nullptr) {
+                Node* next = chain->next;
+                append(chain);
+                chain = next;
+            }
+            head = Node();
+        }
+        if (rehashIndex == oldTableSize) { // all moved
+            vector<Node>().swap(oldNodes);
+            oldTableSize = 0;
+        }
+    }
+}
+
+/**
+ * Complete a resize in progress
+ */
+template <typename Hash>
+void HashTable<Hash>::finishRehash() {
+    while (!oldNodes.empty()) {
+        rehashStep();
+    }
+}
+
+/**
+ * Grow to about twice the buckets when over the maximum load factor (or
+ * as many as it takes to get under it, if the maximum was just lowered),
+ * or shrink to half the maximum load below a quarter of it; bucket
+ * counts are prime
+ */
+template <typename Hash>
+void HashTable<Hash>::checkLoad() {
+    if (!oldNodes.empty()) {
+        return;
+    }
+    if (size > maxLoadFactor * tableSize) {
+        double needed = min(ceil(size / maxLoadFactor), double(UINT_MAX / 2));
+        resize(nextPrime(max(tableSize * 2, unsigned(needed))));
+    } else if (tableSize > minTableSize && size < maxLoadFactor / 4 * tableSize) {
+        resize(max(minTableSize, nextPrime(unsigned(size * 2 / maxLoadFactor))));
     }
-    return hashValue % tableSize;
 }
 
 /**
@@ -148,37 +567,51 @@ unsigned int hashValue = 0;
  *
  * @param bid The bid to insert
  */
-void HashTable::Insert(Bid bid) {
+template <typename Hash>
+void HashTable<Hash>::Insert(Bid bid) {
     // FIXME (4): Implement logic to insert a bid
-    unsigned key = hash(bid.bidId); 
-    Node* newNode = new Node(bid, key);// create the key for the given bid
+    unsigned key; // create the key for the given bid
+    Node* head = bucket(bid.bidId, key);
     // retrieve node using key
-    if(nodes[key] == nullptr){// if no entry found for the key
-        nodes[key] = newNode; // assign this node to the key position
-    }else if(nodes[key].key == UINT_MAX){// else if node is not used
-         // assign old node key to UNIT_MAX, set to key, set old node to bid and old node next to null pointer
-         nodes[key].key = key;
-         nodes[key].bid = bid;
-         nodes[key].next = nullptr;
+    if(head->key == UINT_MAX){// if the bucket's node is not used
+         // set to key, set node to bid and node next to null pointer
+         head->key = key;
+         head->bid = bid;
+         head->next = nullptr;
         }else{// else find the next open node
-            // add new newNode to end
-            Node* current = nodes[key];
+            // add new node to end
+            Node* current = head;
             while(current->next != nullptr){
                 current = current->next;
             }
-            current->next = newNode;
+            current->next = pool.New(bid, key);
         }
+    size++;
+    rehashStep();
+    checkLoad();
 }
 
 /**
  * Print all bids
  */
-void HashTable::PrintAll() {
+template <typename Hash>
+void HashTable<Hash>::PrintAll() {
     // FIXME (5): Implement logic to print all bids
-    for(unsigned int i = 0; i < tableSize; i++) {
-        if(nodes[i].key != UINT_MAX) {// if key not equal to UINT_MAx
-           cout<<"Key:" << nodes[i].key << " | BidID:" << nodes[i].bid.bidId << " | Title:" << nodes[i].bid.title << " | Amount:" << nodes[i].bid.amount << " | Fund:" << nodes[i].bid.fund << endl;// output key, bidID, title, amount and fund
-           Node*node = nodes[i].next; // node is equal to next iter
+    if (!oldNodes.empty()) {// buckets not yet rehashed first
+        printBuckets(oldNodes, rehashIndex);
+    }
+    printBuckets(nodes, 0);
+}
+
+/**
+ * Print the bids in a table's buckets from first on
+ */
+template <typename Hash>
+void HashTable<Hash>::printBuckets(vector<Node>& table, unsigned int first) {
+    for(unsigned int i = first; i < table.size(); i++) {
+        if(table[i].key != UINT_MAX) {// if key not equal to UINT_MAx
+           cout<<"Key:" << table[i].key << " | BidID:" << table[i].bid.bidId << " | Title:" << table[i].bid.title << " | Amount:" << table[i].bid.amount << " | Fund:" << table[i].bid.fund << endl;// output key, bidID, title, amount and fund
+           Node*node = table[i].next; // node is equal to next iter
             while(node != nullptr){// while node not equal to nullptr
                cout<<"Key:" << node->key << " | BidID:" << node->bid.bidId << " | Title:" << node->bid.title << " | Amount:" << node->bid.amount << " | Fund:" << node->bid.fund << endl;// output key, bidID, title, amount and fund
                node = node->next;// node is equal to next node
@@ -192,24 +625,43 @@ void HashTable::PrintAll() {
  *
  * @param bidId The bid id to search for
  */
-void HashTable::Remove(string bidId) {
+template <typename Hash>
+void HashTable<Hash>::Remove(string bidId) {
     // FIXME (6): Implement logic to remove a bid
-    unsigned key = hash(bidId);
+    unsigned key;
+    rehashStep();
    
  // Get the head node at this key
-    Node* current = nodes[key];
-    Node* previous = nullptr;
+    Node* head = bucket(bidId, key);
+    if (head->key == UINT_MAX) {
+        return; // empty bucket
+    }
+
+    // The head lives in the vector: pull the next node up into it
+    if (head->bid.bidId == bidId) {
+        Node* next = head->next;
+        if (next == nullptr) {
+            head->key = UINT_MAX;
+            head->bid = Bid();
+        } else {
+            head->bid = next->bid;
+            head->next = next->next;
+            pool.Delete(next); // Free memory
+        }
+        size--;
+        checkLoad();
+        return;
+    }
 
     // Traverse the chain to find the matching bidId
+    Node* previous = head;
+    Node* current = head->next;
     while (current != nullptr) {
         if (current->bid.bidId == bidId) {
-            // If it's the first node in the chain
-            if (previous == nullptr) {
-                nodes[key] = current->next;
-            } else {
-                previous->next = current->next;
-            }
-            delete current; // Free memory
+            previous->next = current->next;
+            pool.Delete(current); // Free memory
+            size--;
+            checkLoad();
             return;
         }
         previous = current;
@@ -218,32 +670,365 @@ void HashTable::Remove(string bidId) {
 
 }
 
+/**
+ * Remove every bid whose id is listed. The ids are grouped by bucket so
+ * each affected chain is walked once, however many of its ids are given.
+ *
+ * @param bidIds The bid ids to remove
+ * @return the number of bids removed
+ */
+template <typename Hash>
+int HashTable<Hash>::RemoveAll(const vector<string>& bidIds) {
+    finishRehash(); // bulk removal works on a single table
+    unordered_set<string> doomed(bidIds.begin(), bidIds.end());
+    vector<unsigned int> buckets;
+    for (const string& bidId : doomed) {
+        buckets.push_back(hash(bidId));
+    }
+    sort(buckets.begin(), buckets.end());
+    buckets.erase(unique(buckets.begin(), buckets.end()), buckets.end());
+
+    int removed = 0;
+    for (unsigned int key : buckets) {
+        Node* head = &nodes[key];
+        if (head->key == UINT_MAX) {
+            continue; // empty bucket
+        }
+
+        // unlink matching chain nodes behind the head
+        Node* previous = head;
+        Node* current = head->next;
+        while (current != nullptr) {
+            if (doomed.count(current->bid.bidId) > 0) {
+                previous->next = current->next;
+                pool.Delete(current);
+                removed++;
+            } else {
+                previous = current;
+            }
+            current = previous->next;
+        }
+
+        // the head lives in the vector: pull the next node up into it
+        if (doomed.count(head->bid.bidId) > 0) {
+            Node* next = head->next;
+            if (next == nullptr) {
+                head->key = UINT_MAX;
+                head->bid = Bid();
+            } else {
+                head->bid = next->bid;
+                head->next = next->next;
+                pool.Delete(next);
+            }
+            removed++;
+        }
+    }
+    size -= removed;
+    checkLoad();
+    return removed;
+}
+
 /**
  * Search for the specified bidId
  *
  * @param bidId The bid id to search for
  */
-Bid HashTable::Search(string bidId) {
+template <typename Hash>
+Bid HashTable<Hash>::Search(string bidId) {
     Bid bid;
 
     // FIXME (7): Implement logic to search for and return a bid
 
-    unsigned key = hash(bidId);
-    Node* current = nodes[key];
-    if (current != nullptr && current->bid.bidId == bidId) {
-         return current->bid;//return node bid
-    };
-    if ((current -> key = UINT_MAX)) {// if no entry found for the key
+    unsigned key;
+    rehashStep();
+    Node* current = bucket(bidId, key);
+    if (current->key == UINT_MAX) {// if no entry found for the key
       return bid;// return bid
     }
     while(current != nullptr){// while node not equal to nullptr
         if(current->bid.bidId == bidId){// if the current node matches, return it
             return current->bid;
+        }
         current = current->next;// node is equal to next node
-}}
+    }
     return bid;
 }
 
+/**
+ * Number of bids in the table
+ */
+template <typename Hash>
+size_t HashTable<Hash>::Size() {
+    return size;
+}
+
+/**
+ * Number of buckets bids are being added to
+ */
+template <typename Hash>
+unsigned int HashTable<Hash>::BucketCount() {
+    return tableSize;
+}
+
+/**
+ * Bids per bucket
+ */
+template <typename Hash>
+double HashTable<Hash>::LoadFactor() {
+    return double(size) / tableSize;
+}
+
+/**
+ * Set the load factor the table grows past; it shrinks below a quarter
+ * of it
+ */
+template <typename Hash>
+void HashTable<Hash>::SetMaxLoadFactor(double loadFactor) {
+    maxLoadFactor = loadFactor;
+    finishRehash();
+    checkLoad();
+}
+
+/**
+ * Number of bids in each bucket
+ */
+template <typename Hash>
+vector<size_t> HashTable<Hash>::ChainLengths() {
+    finishRehash();
+    vector<size_t> lengths(tableSize, 0);
+    for (unsigned int i = 0; i < tableSize; ++i) {
+        if (nodes[i].key != UINT_MAX) {
+            for (Node* node = &nodes[i]; node != nullptr; node = node->next) {
+                lengths[i]++;
+            }
+        }
+    }
+    return lengths;
+}
+
+//============================================================================
+// Open-addressing (Swiss table) hash table class definition
+//============================================================================
+
+/**
+ * Same interface as HashTable, but with open addressing: bids are stored
+ * inline in one flat array, next to an array of one-byte control codes
+ * (empty, deleted, or 7 bits of the bid's hash). A lookup scans the
+ * control bytes of a group of 16 slots at once with SSE2 and compares
+ * only the ids whose bytes match. Groups are probed in triangular order,
+ * stopping at the first group with an empty slot.
+ *
+ * Removed slots become tombstones unless their group still has an empty
+ * slot, in which case no probe ever ran past it and the slot can simply
+ * be emptied. The table rehashes at 7/8 occupancy counting tombstones,
+ * doubling if it is really full and otherwise just sweeping them out.
+ */
+class SwissHashTable {
+
+private:
+    vector<int8_t> control;
+    vector<Bid> slots;
+    size_t size = 0;
+    size_t tombstones = 0;
+    size_t groupMask = 0; // number of groups - 1
+
+    static size_t hashId(const string& bidId) {
+        return std::hash<string>()(bidId);
+    }
+
+    uint32_t match(size_t group, int8_t value) const;
+    size_t find(const string& bidId) const;
+    void place(Bid&& bid, size_t hash);
+    void rehash(size_t capacity);
+
+public:
+    SwissHashTable();
+    virtual ~SwissHashTable() {}
+    void Insert(Bid bid);
+    void PrintAll();
+    void Remove(string bidId);
+    Bid Search(string bidId);
+    size_t Size();
+    double LoadFactor();
+};
+
+/**
+ * Index of the lowest set bit of a non-zero mask
+ */
+inline int lowestBit(uint32_t mask) {
+#ifdef __GNUC__
+    return __builtin_ctz(mask);
+#else
+    int bit = 0;
+    while ((mask & 1) == 0) {
+        mask >>= 1;
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+/**
+ * Default constructor
+ */
+SwissHashTable::SwissHashTable() {
+    rehash(SWISS_MIN_CAPACITY);
+}
+
+/**
+ * Bit i set for each slot i of the group whose control byte is value
+ */
+uint32_t SwissHashTable::match(size_t group, int8_t value) const {
+    const int8_t* bytes = &control[group * SWISS_GROUP_SIZE];
+#ifdef __SSE2__
+    __m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes));
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(value)));
+#else
+    uint32_t mask = 0;
+    for (size_t i = 0; i < SWISS_GROUP_SIZE; ++i) {
+        mask |= uint32_t(bytes[i] == value) << i;
+    }
+    return mask;
+#endif
+}
+
+/**
+ * Slot holding the bid id, or SIZE_MAX
+ */
+size_t SwissHashTable::find(const string& bidId) const {
+    size_t hash = hashId(bidId);
+    int8_t tag = hash & 0x7f;
+    size_t group = (hash >> 7) & groupMask;
+    for (size_t probe = 1;; ++probe) {
+        for (uint32_t candidates = match(group, tag); candidates != 0; candidates &= candidates - 1) {
+            size_t slot = group * SWISS_GROUP_SIZE + lowestBit(candidates);
+            if (slots[slot].bidId == bidId) {
+                return slot;
+            }
+        }
+        if (match(group, SWISS_EMPTY) != 0) {
+            return SIZE_MAX;
+        }
+        group = (group + probe) & groupMask;
+    }
+}
+
+/**
+ * Put a bid known not to be in the table into the first free slot on its
+ * probe sequence
+ */
+void SwissHashTable::place(Bid&& bid, size_t hash) {
+    size_t group = (hash >> 7) & groupMask;
+    for (size_t probe = 1;; ++probe) {
+        uint32_t free = match(group, SWISS_EMPTY) | match(group, SWISS_DELETED);
+        if (free != 0) {
+            size_t slot = group * SWISS_GROUP_SIZE + lowestBit(free);
+            if (control[slot] == SWISS_DELETED) {
+                tombstones--;
+            }
+            control[slot] = hash & 0x7f;
+            slots[slot] = move(bid);
+            size++;
+            return;
+        }
+        group = (group + probe) & groupMask;
+    }
+}
+
+/**
+ * Move every bid into fresh arrays of the given capacity, dropping the
+ * tombstones
+ */
+void SwissHashTable::rehash(size_t capacity) {
+    vector<int8_t> oldControl(capacity, SWISS_EMPTY);
+    vector<Bid> oldSlots(capacity);
+    oldControl.swap(control);
+    oldSlots.swap(slots);
+    groupMask = capacity / SWISS_GROUP_SIZE - 1;
+    size = 0;
+    tombstones = 0;
+
+    for (size_t i = 0; i < oldControl.size(); ++i) {
+        if (oldControl[i] >= 0) {
+            place(move(oldSlots[i]), hashId(oldSlots[i].bidId));
+        }
+    }
+}
+
+/**
+ * Insert a bid; a bid with the same id already in the table is replaced
+ *
+ * @param bid The bid to insert
+ */
+void SwissHashTable::Insert(Bid bid) {
+    size_t slot = find(bid.bidId);
+    if (slot != SIZE_MAX) {
+        slots[slot] = bid;
+        return;
+    }
+    if ((size + tombstones + 1) * 8 > control.size() * 7) {
+        rehash((size + 1) * 16 > control.size() * 7 ? control.size() * 2 : control.size());
+    }
+    size_t hash = hashId(bid.bidId);
+    place(move(bid), hash);
+}
+
+/**
+ * Print all bids
+ */
+void SwissHashTable::PrintAll() {
+    for (size_t i = 0; i < control.size(); ++i) {
+        if (control[i] >= 0) {
+            cout << "Key:" << i << " | BidID:" << slots[i].bidId << " | Title:" << slots[i].title
+                 << " | Amount:" << slots[i].amount << " | Fund:" << slots[i].fund << endl;
+        }
+    }
+}
+
+/**
+ * Remove a bid
+ *
+ * @param bidId The bid id to remove
+ */
+void SwissHashTable::Remove(string bidId) {
+    size_t slot = find(bidId);
+    if (slot == SIZE_MAX) {
+        return;
+    }
+    slots[slot] = Bid();
+    if (match(slot / SWISS_GROUP_SIZE, SWISS_EMPTY) != 0) {
+        control[slot] = SWISS_EMPTY;
+    } else {
+        control[slot] = SWISS_DELETED;
+        tombstones++;
+    }
+    size--;
+}
+
+/**
+ * Search for the specified bidId
+ *
+ * @param bidId The bid id to search for
+ */
+Bid SwissHashTable::Search(string bidId) {
+    size_t slot = find(bidId);
+    return slot == SIZE_MAX ? Bid() : slots[slot];
+}
+
+/**
+ * Number of bids in the table
+ */
+size_t SwissHashTable::Size() {
+    return size;
+}
+
+/**
+ * Bids per slot
+ */
+double SwissHashTable::LoadFactor() {
+    return double(size) / control.size();
+}
+
 //============================================================================
 // Static methods used for testing
 //============================================================================
@@ -260,12 +1045,13 @@ void displayBid(Bid bid) {
 }
 
 /**
- * Load a CSV file containing bids into a container
+ * Read the bids in a CSV file
  *
  * @param csvPath the path to the CSV file to load
- * @return a container holding all the bids read
+ * @return the bids read, in file order
  */
-void loadBids(string csvPath, HashTable* hashTable) {
+vector<Bid> readBids(string csvPath) {
+    vector<Bid> bids;
     cout << "Loading CSV file " << csvPath << endl;
 
     // initialize the CSV Parser using the given path
@@ -292,11 +1078,147 @@ void loadBids(string csvPath, HashTable* hashTable) {
             //cout << "Item: " << bid.title << ", Fund: " << bid.fund << ", Amount: " << bid.amount << endl;
 
             // push this bid to the end
-            hashTable->Insert(bid);
+            bids.push_back(bid);
         }
     } catch (csv::Error &e) {
         std::cerr << e.what() << std::endl;
     }
+    return bids;
+}
+
+/**
+ * Load a CSV file containing bids into a HashTable or SwissHashTable
+ *
+ * @param csvPath the path to the CSV file to load
+ */
+template <typename Table>
+void loadBids(string csvPath, Table* hashTable) {
+    for (const Bid& bid : readBids(csvPath)) {
+        hashTable->Insert(bid);
+    }
+}
+
+/**
+ * Time lookups of every bid id in the file, and of as many missing ids,
+ * in the chained table and the open-addressing table
+ *
+ * @param csvPath the CSV file to load into both tables
+ */
+void compareHashBackends(string csvPath) {
+    const int rounds = 20;
+    vector<Bid> bids = readBids(csvPath);
+    HashTable<> fixed; // never grows, as before resizing was added
+    fixed.SetMaxLoadFactor(1e9);
+    HashTable<> chained;
+    SwissHashTable swiss;
+    for (const Bid& bid : bids) {
+        fixed.Insert(bid);
+        chained.Insert(bid);
+        swiss.Insert(bid);
+    }
+    vector<string> missing;
+    for (const Bid& bid : bids) {
+        missing.push_back(bid.bidId + "x");
+    }
+
+    size_t found = 0;
+    double lookups = 2.0 * rounds * bids.size();
+    HashTable<>* tables[] = { &fixed, &chained };
+    const char* names[] = { "chaining, fixed size", "chaining, resizing" };
+    for (int t = 0; t < 2; ++t) {
+        clock_t ticks = clock();
+        for (int round = 0; round < rounds; ++round) {
+            for (const Bid& bid : bids) {
+                found += !tables[t]->Search(bid.bidId).bidId.empty();
+            }
+            for (const string& bidId : missing) {
+                found += !tables[t]->Search(bidId).bidId.empty();
+            }
+        }
+        ticks = clock() - ticks;
+        cout << names[t] << ", " << tables[t]->BucketCount() << " buckets, load factor "
+             << tables[t]->LoadFactor() << ": "
+             << lookups / ticks * CLOCKS_PER_SEC << " lookups/s" << endl;
+    }
+
+    clock_t ticks = clock();
+    for (int round = 0; round < rounds; ++round) {
+        for (const Bid& bid : bids) {
+            found += !swiss.Search(bid.bidId).bidId.empty();
+        }
+        for (const string& bidId : missing) {
+            found += !swiss.Search(bidId).bidId.empty();
+        }
+    }
+    ticks = clock() - ticks;
+    cout << "open addressing, load factor " << swiss.LoadFactor() << ": "
+         << lookups / ticks * CLOCKS_PER_SEC << " lookups/s" << endl;
+    cout << found << " hits" << endl;
+}
+
+/**
+ * Time one hash policy: load the bids into a resizing chained table,
+ * then report how evenly they spread and how fast lookups run
+ */
+template <typename Hash>
+void timeHashPolicy(const char* name, const vector<Bid>& bids, const vector<string>& missing) {
+    const int rounds = 20;
+    HashTable<Hash> table;
+    for (const Bid& bid : bids) {
+        table.Insert(bid);
+    }
+
+    // chains of 0, 1, 2, 3 and 4 or more bids
+    size_t histogram[5] = {};
+    size_t longest = 0;
+    double probes = 0;
+    for (size_t length : table.ChainLengths()) {
+        histogram[min<size_t>(length, 4)]++;
+        longest = max(longest, length);
+        probes += length * (length + 1) / 2.0;
+    }
+
+    size_t found = 0;
+    clock_t ticks = clock();
+    for (int round = 0; round < rounds; ++round) {
+        for (const Bid& bid : bids) {
+            found += !table.Search(bid.bidId).bidId.empty();
+        }
+        for (const string& bidId : missing) {
+            found += !table.Search(bidId).bidId.empty();
+        }
+    }
+    ticks = max<clock_t>(clock() - ticks, 1);
+    double lookups = 2.0 * rounds * bids.size();
+
+    cout << name << ": chains of 0/1/2/3/4+ bids " << histogram[0] << "/" << histogram[1] << "/"
+         << histogram[2] << "/" << histogram[3] << "/" << histogram[4] << ", longest " << longest
+         << ", " << probes / max<size_t>(table.Size(), 1) << " probes per hit, "
+         << lookups / ticks * CLOCKS_PER_SEC << " lookups/s (" << found << " hits)" << endl;
+}
+
+/**
+ * Compare the hash policies on the chained table with the file's own bid
+ * ids, hits and misses alike
+ *
+ * @param csvPath the CSV file to load
+ */
+void compareHashPolicies(string csvPath) {
+    vector<Bid> bids = readBids(csvPath);
+    vector<string> missing;
+    for (const Bid& bid : bids) {
+        missing.push_back(bid.bidId + "x");
+    }
+    cout << bids.size() << " bids" << endl;
+    timeHashPolicy<IdHash>("identity", bids, missing);
+    timeHashPolicy<Fnv1aHash>("FNV-1a", bids, missing);
+    timeHashPolicy<WyMixHash>("wyhash-style mix", bids, missing);
+    bool crcHardware = false;
+#ifdef CRC32C_SSE42
+    crcHardware = crc32cHardwareAvailable();
+#endif
+    timeHashPolicy<Crc32cHash>(crcHardware ? "CRC32C (SSE4.2)" : "CRC32C (table)", bids, missing);
+    timeHashPolicy<IntegerMixHash>("integer mix", bids, missing);
 }
 
 /**
@@ -337,10 +1259,10 @@ int main(int argc, char* argv[]) {
     clock_t ticks;
 
     // Define a hash table to hold all the bids
-    HashTable* bidTable;
+    HashTable<>* bidTable;
 
     Bid bid;
-    bidTable = new HashTable();
+    bidTable = new HashTable<>();
     
     int choice = 0;
     while (choice != 9) {
@@ -349,6 +1271,10 @@ int main(int argc, char* argv[]) {
         cout << "  2. Display All Bids" << endl;
         cout << "  3. Find Bid" << endl;
         cout << "  4. Remove Bid" << endl;
+        cout << "  5. Remove Many Bids" << endl;
+        cout << "  6. Compare Hash Backends" << endl;
+        cout << "  7. Set Maximum Load Factor" << endl;
+        cout << "  8. Compare Hash Policies" << endl;
         cout << "  9. Exit" << endl;
         cout << "Enter choice: ";
         cin >> choice;
@@ -365,6 +1291,7 @@ int main(int argc, char* argv[]) {
 
             // Calculate elapsed time and display result
             ticks = clock() - ticks; // current clock ticks minus starting clock ticks
+            cout << bidTable->BucketCount() << " buckets, load factor " << bidTable->LoadFactor() << endl;
             cout << "time: " << ticks << " clock ticks" << endl;
             cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
             break;
@@ -393,6 +1320,45 @@ int main(int argc, char* argv[]) {
         case 4:
             bidTable->Remove(bidKey);
             break;
+
+        case 5: {
+            vector<string> bidIds;
+            string line, bidId;
+            cout << "Enter bid ids separated by spaces: ";
+            cin.ignore();
+            getline(cin, line);
+            istringstream ids(line);
+            while (ids >> bidId) {
+                bidIds.push_back(bidId);
+            }
+
+            ticks = clock();
+            int removed = bidTable->RemoveAll(bidIds);
+            ticks = clock() - ticks;
+
+            cout << removed << " bids removed" << endl;
+            cout << "time: " << ticks << " clock ticks" << endl;
+            break;
+        }
+
+        case 6:
+            compareHashBackends(csvPath);
+            break;
+
+        case 7: {
+            double loadFactor;
+            cout << "Enter maximum load factor: ";
+            cin >> loadFactor;
+            if (loadFactor > 0) {
+                bidTable->SetMaxLoadFactor(loadFactor);
+            }
+            cout << bidTable->BucketCount() << " buckets, load factor " << bidTable->LoadFactor() << endl;
+            break;
+        }
+
+        case 8:
+            compareHashPolicies(csvPath);
+            break;
         }
     }
 